@@ -0,0 +1,83 @@
+#include "TimeMeter.hpp"
+#include "matrix/Matrix.hpp"
+#include "matrix/MatrixHash.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+using namespace util;
+using namespace util::matrix;
+
+namespace {
+
+// The element-by-element hash that std::hash<Matrix> used before.
+struct ElementwiseHash {
+    std::size_t operator()(const Matrix<std::int8_t>& matrix) const {
+        std::size_t seed = 0;
+        for (std::int8_t value : matrix) {
+            boost::hash_combine(seed, value);
+        }
+        return seed;
+    }
+};
+
+std::vector<Matrix<std::int8_t>> createBoards(std::size_t size,
+        std::size_t count) {
+    std::vector<Matrix<std::int8_t>> result;
+    result.reserve(count);
+    Matrix<std::int8_t> board{size, size, 0};
+    std::uint64_t state = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        // A few cells change between consecutive boards, like in a search.
+        for (int j = 0; j < 3; ++j) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            board[(state >> 33) % board.size()] = (state >> 20) % 3;
+        }
+        result.push_back(board);
+    }
+    return result;
+}
+
+template<typename Hash>
+void run(const char* name, const std::vector<Matrix<std::int8_t>>& boards) {
+    Hash hash;
+    TimeMeter timeMeter;
+    std::size_t checksum = 0;
+    for (const auto& board : boards) {
+        checksum += hash(board);
+    }
+    auto hashTime = timeMeter.realTime();
+
+    timeMeter.reset();
+    std::unordered_set<Matrix<std::int8_t>, Hash> set;
+    set.reserve(boards.size());
+    for (const auto& board : boards) {
+        set.insert(board);
+    }
+    auto insertTime = timeMeter.realTime();
+
+    std::cout << std::setw(12) << std::left << name
+            << " hash: " << std::setw(8) << std::right
+            << hashTime.total_milliseconds() << " ms"
+            << "  insert: " << std::setw(8)
+            << insertTime.total_milliseconds() << " ms"
+            << "  (" << set.size() << " unique, " << checksum % 1000 << ")\n";
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t size = argc > 1 ? std::atoi(argv[1]) : 100;
+    std::size_t count = argc > 2 ? std::atoi(argv[2]) : 100000;
+    std::cout << "Board size: " << size << "x" << size << ", boards: "
+            << count << "\n";
+    auto boards = createBoards(size, count);
+    run<ElementwiseHash>("elementwise", boards);
+    run<MatrixHash>("xxh64", boards);
+}
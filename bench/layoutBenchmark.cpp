@@ -0,0 +1,94 @@
+#include "TimeMeter.hpp"
+#include "matrix/LayoutMatrix.hpp"
+#include "matrix/SquareMatrix.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace util;
+using namespace util::matrix;
+
+namespace {
+
+bool isBlocked(Point p) {
+    return (p.x * 7 + p.y * 13) % 11 == 0;
+}
+
+template<typename MatrixType>
+long stencil(std::size_t size, int iterations) {
+    MatrixType input{size, size};
+    MatrixType output{size, size};
+    for (Point p : matrixRange(input)) {
+        input[p] = (p.x ^ p.y) & 0xff;
+    }
+    Point p;
+    for (int i = 0; i < iterations; ++i) {
+        for (p.y = 1; p.y < static_cast<int>(size) - 1; ++p.y) {
+            for (p.x = 1; p.x < static_cast<int>(size) - 1; ++p.x) {
+                output[p] = (4 * input[p] + input[p - p10] + input[p + p10] +
+                        input[p - p01] + input[p + p01]) / 8;
+            }
+        }
+        std::swap(input, output);
+    }
+    return input[Point(size / 2, size / 2)];
+}
+
+template<typename MatrixType>
+long bfs(std::size_t size, int iterations) {
+    long result = 0;
+    MatrixType distance{size, size};
+    std::vector<Point> queue;
+    queue.reserve(size * size);
+    for (int i = 0; i < iterations; ++i) {
+        distance.fill(-1);
+        queue.clear();
+        Point start(size / 2, size / 2);
+        distance[start] = 0;
+        queue.push_back(start);
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            Point p = queue[head];
+            for (Point d : square::neighbors.data) {
+                Point next = p + d;
+                if (isInsideMatrix(distance, next) && distance[next] < 0 &&
+                        !isBlocked(next)) {
+                    distance[next] = distance[p] + 1;
+                    queue.push_back(next);
+                }
+            }
+        }
+        result += distance[queue.back()];
+    }
+    return result;
+}
+
+template<typename MatrixType>
+void run(const char* name, std::size_t size, int iterations) {
+    TimeMeter timeMeter;
+    long stencilResult = stencil<MatrixType>(size, iterations);
+    auto stencilTime = timeMeter.realTime();
+    timeMeter.reset();
+    long bfsResult = bfs<MatrixType>(size, iterations);
+    auto bfsTime = timeMeter.realTime();
+    std::cout << std::setw(12) << std::left << name
+            << " stencil: " << std::setw(8) << std::right
+            << stencilTime.total_milliseconds() << " ms"
+            << "  bfs: " << std::setw(8)
+            << bfsTime.total_milliseconds() << " ms"
+            << "  (" << stencilResult << ", " << bfsResult << ")\n";
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t size = argc > 1 ? std::atoi(argv[1]) : 2048;
+    int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+    std::cout << "Matrix size: " << size << "x" << size << ", iterations: "
+            << iterations << "\n";
+    run<Matrix<int>>("row-major", size, iterations);
+    run<TiledMatrix<int, 8>>("tiled 8x8", size, iterations);
+    run<TiledMatrix<int, 16>>("tiled 16x16", size, iterations);
+    run<MortonMatrix<int>>("morton", size, iterations);
+}
@@ -0,0 +1,59 @@
+#ifndef UTIL_ALIGNEDALLOCATOR_HPP
+#define UTIL_ALIGNEDALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <stdlib.h>
+
+namespace util {
+
+// Allocates every block on an `alignment` byte boundary.
+template<typename T, std::size_t alignment>
+struct AlignedAllocator {
+    static_assert(alignment >= alignof(T),
+            "Alignment is smaller than the natural alignment of the type.");
+    static_assert((alignment & (alignment - 1)) == 0,
+            "Alignment must be a power of two.");
+    static_assert(alignment % sizeof(void*) == 0,
+            "Alignment must be a multiple of the pointer size.");
+
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        void* result = nullptr;
+        if (::posix_memalign(&result, alignment, n * sizeof(T)) != 0) {
+            throw std::bad_alloc{};
+        }
+        return static_cast<T*>(result);
+    }
+
+    void deallocate(T* p, std::size_t /*n*/) {
+        ::free(p);
+    }
+};
+
+template<typename T, typename U, std::size_t alignment>
+bool operator==(const AlignedAllocator<T, alignment>&,
+        const AlignedAllocator<U, alignment>&) {
+    return true;
+}
+
+template<typename T, typename U, std::size_t alignment>
+bool operator!=(const AlignedAllocator<T, alignment>&,
+        const AlignedAllocator<U, alignment>&) {
+    return false;
+}
+
+} // namespace util
+
+#endif // UTIL_ALIGNEDALLOCATOR_HPP
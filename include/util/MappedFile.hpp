@@ -0,0 +1,64 @@
+#ifndef UTIL_MAPPEDFILE_HPP
+#define UTIL_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace util {
+
+enum class MapMode {
+    // PROT_READ, shared. Writing to the mapping crashes the process.
+    readOnly,
+    // PROT_READ | PROT_WRITE, shared. Writes go to the file.
+    readWrite,
+    // PROT_READ | PROT_WRITE, private. Writes are not visible to others and
+    // never reach the file, and untouched pages still share the page cache.
+    copyOnWrite
+};
+
+// Values for madvise().
+enum class AccessHint { normal, sequential, random, willNeed, dontNeed };
+
+// A whole file mapped into memory. The mapping is released on destruction.
+// Errors are reported with std::system_error.
+class MappedFile {
+    std::string fileName_;
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+    MapMode mode_ = MapMode::readOnly;
+
+    void map(int fd, bool populate);
+public:
+    MappedFile() = default;
+    // populate uses MAP_POPULATE to read the whole file ahead.
+    MappedFile(const std::string& fileName, MapMode mode,
+            bool populate = false);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    // Creates or truncates the file to size bytes and maps it read-write.
+    static MappedFile create(const std::string& fileName, std::size_t size,
+            bool populate = false);
+
+    const std::string& fileName() const { return fileName_; }
+    char* data() { return data_; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    MapMode mode() const { return mode_; }
+    bool isOpen() const { return data_ != nullptr; }
+
+    void advise(AccessHint hint);
+    // The range is extended to page boundaries.
+    void advise(AccessHint hint, std::size_t offset, std::size_t length);
+    // Writes the changes back to the file (msync). No-op for read-only and
+    // copy-on-write mappings.
+    void flush(bool wait = true);
+    void close();
+};
+
+} // namespace util
+
+#endif // UTIL_MAPPEDFILE_HPP
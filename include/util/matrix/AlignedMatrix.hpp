@@ -0,0 +1,170 @@
+#ifndef UTIL_MATRIX_ALIGNEDMATRIX_HPP
+#define UTIL_MATRIX_ALIGNEDMATRIX_HPP
+
+#include "AlignedAllocator.hpp"
+#include "Matrix.hpp"
+#include "StridedIterator.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+namespace matrix {
+
+// Same interface as Matrix, but every row starts on an `alignment` byte
+// boundary. Rows are padded to stride() elements; the padding is never
+// visited by the iterators.
+template<typename T, std::size_t alignment = 64>
+class AlignedMatrix {
+    typedef std::vector<T, AlignedAllocator<T, alignment>> Data;
+    std::size_t width_, height_, stride_;
+    Data data_;
+
+    static std::size_t gcd(std::size_t a, std::size_t b) {
+        return b == 0 ? a : gcd(b, a % b);
+    }
+
+    static std::size_t calculateStride(std::size_t width) {
+        std::size_t unit = alignment / gcd(alignment, sizeof(T));
+        return (width + unit - 1) / unit * unit;
+    }
+
+    template<typename Iterator>
+    void assign(Iterator begin, Iterator end) {
+        std::copy(begin, end, this->begin());
+    }
+public:
+    typedef T valueType;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef StridedIterator<T> iterator;
+    typedef StridedIterator<const T> const_iterator;
+
+    AlignedMatrix(): width_(0), height_(0), stride_(0) {}
+
+    AlignedMatrix(std::size_t width, std::size_t height,
+            const std::initializer_list<T>& values):
+        AlignedMatrix(width, height, values.begin(), values.end())
+    {}
+
+    template<typename Iterator>
+    AlignedMatrix(std::size_t width, std::size_t height,
+            Iterator begin, Iterator end):
+        AlignedMatrix(width, height)
+    {
+        assert(static_cast<std::size_t>(std::distance(begin, end)) ==
+                size());
+        assign(begin, end);
+    }
+
+    AlignedMatrix(std::size_t width, std::size_t height,
+            const T& defValue = T()):
+        width_(width), height_(height), stride_(calculateStride(width)),
+        data_(stride_ * height, defValue)
+    {}
+
+    template<typename U, typename OtherAllocator>
+    explicit AlignedMatrix(const Matrix<U, OtherAllocator>& other):
+        AlignedMatrix(other.width(), other.height())
+    {
+        static_assert(std::is_convertible<U, T>::value,
+                "Cannot convert between matrices of incompatible types.");
+        assign(other.begin(), other.end());
+    }
+
+    AlignedMatrix(const AlignedMatrix& ) = default;
+    AlignedMatrix(AlignedMatrix&& other) noexcept :
+            width_(other.width_), height_(other.height_),
+            stride_(other.stride_), data_(std::move(other.data_)) {
+        other.width_ = 0;
+        other.height_ = 0;
+        other.stride_ = 0;
+        other.data_.clear();
+    }
+    AlignedMatrix& operator=(const AlignedMatrix& ) = default;
+    AlignedMatrix& operator=(AlignedMatrix&& other) noexcept {
+        this->width_ = other.width_;
+        this->height_ = other.height_;
+        this->stride_ = other.stride_;
+        this->data_ = std::move(other.data_);
+        other.width_ = 0;
+        other.height_ = 0;
+        other.stride_ = 0;
+        other.data_.clear();
+        return *this;
+    }
+
+    reference operator[](Point p) {
+        assert(isInsideMatrix(*this, p));
+        return data_[p.y*stride_ + p.x];
+    }
+    const_reference operator[](Point p) const {
+        assert(isInsideMatrix(*this, p));
+        return data_[p.y*stride_ + p.x];
+    }
+
+    T* row(std::size_t y) { return data_.data() + y * stride_; }
+    const T* row(std::size_t y) const { return data_.data() + y * stride_; }
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+
+    std::size_t size() const { return width_ * height_; }
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    std::size_t stride() const { return stride_; }
+
+    void reset(std::size_t newWidth, std::size_t newHeight,
+            const T& defValue = T())
+    {
+        width_ = newWidth;
+        height_ = newHeight;
+        stride_ = calculateStride(width_);
+        data_.resize(stride_ * height_);
+        fill(defValue);
+    }
+    void fill(const T& value)
+    {
+        std::fill(data_.begin(), data_.end(), value);
+    }
+    void clear()
+    {
+        data_.clear();
+        width_ = 0;
+        height_ = 0;
+        stride_ = 0;
+    }
+
+    bool operator==(const AlignedMatrix& other) const
+    {
+        return width_ == other.width_ && height_ == other.height_
+                && std::equal(begin(), end(), other.begin());
+    }
+
+    iterator begin() {
+        return width_ == 0 ? end() : iterator{data(), width_, stride_};
+    }
+    iterator end() {
+        return iterator{data() + stride_ * height_, width_, stride_};
+    }
+    const_iterator begin() const {
+        return width_ == 0 ? end() : const_iterator{data(), width_, stride_};
+    }
+    const_iterator end() const {
+        return const_iterator{data() + stride_ * height_, width_, stride_};
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+};
+
+template<typename T, std::size_t alignment>
+inline bool operator!=(const AlignedMatrix<T, alignment>& lhs,
+        const AlignedMatrix<T, alignment>& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_ALIGNEDMATRIX_HPP
@@ -0,0 +1,146 @@
+#ifndef UTIL_MATRIX_BINARYMATRIXIO_HPP
+#define UTIL_MATRIX_BINARYMATRIXIO_HPP
+
+#include "Matrix.hpp"
+#include "MatrixFileFormat.hpp"
+#include "Point.hpp"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+// Saving and loading matrices and vectors of trivially copyable types in the
+// format of MatrixFileFormat.hpp. The cells are written as one block per row,
+// so the speed is close to that of the stream. Files written on a machine
+// with the other byte order are converted when loading arithmetic types,
+// enums and Points; for other types such files are rejected.
+
+namespace util {
+namespace matrix {
+
+namespace detail {
+
+template<typename T>
+std::enable_if_t<std::is_arithmetic<T>::value || std::is_enum<T>::value,
+        bool>
+byteSwapElements(T* data, std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+        char* bytes = reinterpret_cast<char*>(data + i);
+        std::reverse(bytes, bytes + sizeof(T));
+    }
+    return true;
+}
+
+inline bool byteSwapElements(Point* data, std::size_t size) {
+    return byteSwapElements(reinterpret_cast<int*>(data), size * 2);
+}
+
+template<typename T>
+std::enable_if_t<!std::is_arithmetic<T>::value && !std::is_enum<T>::value,
+        bool>
+byteSwapElements(T* /*data*/, std::size_t /*size*/) {
+    return false;
+}
+
+inline void writeBinary(std::ostream& os, const void* data,
+        std::size_t size) {
+    if (!os.write(static_cast<const char*>(data), size)) {
+        BOOST_THROW_EXCEPTION(MatrixFileError{"Failed to write matrix."});
+    }
+}
+
+inline void readBinary(std::istream& is, void* data, std::size_t size) {
+    if (!is.read(static_cast<char*>(data), size)) {
+        BOOST_THROW_EXCEPTION(MatrixFileError{
+                "Unexpected end of matrix file."});
+    }
+}
+
+template<typename T>
+MatrixFileHeader readBinaryHeader(std::istream& is, bool& swapped) {
+    static_assert(std::is_trivially_copyable<T>::value,
+            "Binary IO needs a trivially copyable type.");
+    MatrixFileHeader header;
+    readBinary(is, &header, sizeof(header));
+    swapped = checkMatrixFileHeader(header, sizeof(T));
+    return header;
+}
+
+template<typename T>
+void readBinaryData(std::istream& is, T* data, std::size_t size,
+        bool swapped) {
+    readBinary(is, data, size * sizeof(T));
+    if (swapped && !byteSwapElements(data, size)) {
+        BOOST_THROW_EXCEPTION(MatrixFileError{
+                "Cannot convert the byte order of the matrix file."});
+    }
+}
+
+} // namespace detail
+
+// Works with anything that has data() and stride(), e.g. Matrix,
+// AlignedMatrix or MatrixView.
+template<typename MatrixType>
+void saveMatrixBinary(std::ostream& os, const MatrixType& matrix) {
+    using T = std::remove_const_t<typename MatrixType::valueType>;
+    static_assert(std::is_trivially_copyable<T>::value,
+            "Binary IO needs a trivially copyable type.");
+    MatrixFileHeader header = makeMatrixFileHeader(sizeof(T),
+            matrix.width(), matrix.height());
+    detail::writeBinary(os, &header, sizeof(header));
+    if (matrix.stride() == matrix.width()) {
+        detail::writeBinary(os, matrix.data(),
+                matrix.width() * matrix.height() * sizeof(T));
+        return;
+    }
+    for (std::size_t y = 0; y < matrix.height(); ++y) {
+        detail::writeBinary(os, matrix.data() + y * matrix.stride(),
+                matrix.width() * sizeof(T));
+    }
+}
+
+template<typename T, typename Allocator = std::allocator<T>>
+Matrix<T, Allocator> loadMatrixBinary(std::istream& is,
+        const Allocator& allocator = Allocator()) {
+    bool swapped;
+    MatrixFileHeader header = detail::readBinaryHeader<T>(is, swapped);
+    // Throws if width * height overflows.
+    matrixFileCellCount(header);
+    Matrix<T, Allocator> result{header.width, header.height, T(),
+            allocator};
+    detail::readBinaryData(is, result.data(), result.size(), swapped);
+    return result;
+}
+
+// Vectors are stored as a matrix with one row, so they can also be loaded
+// with loadMatrixBinary().
+template<typename T, typename Allocator>
+void saveVectorBinary(std::ostream& os,
+        const std::vector<T, Allocator>& values) {
+    static_assert(std::is_trivially_copyable<T>::value,
+            "Binary IO needs a trivially copyable type.");
+    MatrixFileHeader header = makeMatrixFileHeader(sizeof(T),
+            values.size(), 1);
+    detail::writeBinary(os, &header, sizeof(header));
+    detail::writeBinary(os, values.data(), values.size() * sizeof(T));
+}
+
+template<typename T, typename Allocator = std::allocator<T>>
+std::vector<T, Allocator> loadVectorBinary(std::istream& is,
+        const Allocator& allocator = Allocator()) {
+    bool swapped;
+    MatrixFileHeader header = detail::readBinaryHeader<T>(is, swapped);
+    std::vector<T, Allocator> result(matrixFileCellCount(header), T(),
+            allocator);
+    detail::readBinaryData(is, result.data(), result.size(), swapped);
+    return result;
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_BINARYMATRIXIO_HPP
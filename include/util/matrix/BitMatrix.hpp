@@ -0,0 +1,315 @@
+#ifndef UTIL_MATRIX_BITMATRIX_HPP
+#define UTIL_MATRIX_BITMATRIX_HPP
+
+#include "Matrix.hpp"
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace util {
+namespace matrix {
+
+// Matrix of bits stored in 64-bit words. Every row starts at a new word, and
+// the unused bits at the end of each row are kept zero, so whole rows can be
+// processed a word at a time. Bit x of a row is bit (x % 64) of word x / 64.
+class BitMatrix {
+public:
+    typedef std::uint64_t Word;
+    static constexpr std::size_t wordBits = 64;
+
+    class reference {
+        Word& word_;
+        Word mask_;
+    public:
+        reference(Word& word, Word mask): word_(word), mask_(mask) {}
+
+        operator bool() const { return (word_ & mask_) != 0; }
+
+        reference& operator=(bool value) {
+            if (value) {
+                word_ |= mask_;
+            } else {
+                word_ &= ~mask_;
+            }
+            return *this;
+        }
+
+        reference& operator=(const reference& other) {
+            return *this = static_cast<bool>(other);
+        }
+
+        void flip() { word_ ^= mask_; }
+    };
+
+    typedef bool valueType;
+    typedef bool const_reference;
+
+private:
+    std::size_t width_, height_, wordsPerRow_;
+    std::vector<Word> data_;
+
+    static std::size_t wordCount(std::size_t width) {
+        return (width + wordBits - 1) / wordBits;
+    }
+
+    static Word bitMask(std::size_t x) {
+        return static_cast<Word>(1) << (x % wordBits);
+    }
+
+    std::size_t wordIndex(Point p) const {
+        return p.y * wordsPerRow_ + static_cast<std::size_t>(p.x) / wordBits;
+    }
+
+    Word lastWordMask() const {
+        std::size_t bits = width_ % wordBits;
+        return bits == 0 ? ~static_cast<Word>(0) :
+                (static_cast<Word>(1) << bits) - 1;
+    }
+
+    void clearPadding() {
+        if (wordsPerRow_ == 0) {
+            return;
+        }
+        Word mask = lastWordMask();
+        for (std::size_t y = 0; y < height_; ++y) {
+            rowWords(y)[wordsPerRow_ - 1] &= mask;
+        }
+    }
+
+    template<typename Operation>
+    BitMatrix& combine(const BitMatrix& other, Operation operation) {
+        assert(width_ == other.width_ && height_ == other.height_);
+        for (std::size_t i = 0; i < data_.size(); ++i) {
+            data_[i] = operation(data_[i], other.data_[i]);
+        }
+        return *this;
+    }
+
+public:
+    BitMatrix(): width_(0), height_(0), wordsPerRow_(0) {}
+
+    BitMatrix(std::size_t width, std::size_t height, bool value = false):
+        width_(width), height_(height), wordsPerRow_(wordCount(width)),
+        data_(wordsPerRow_ * height, value ? ~static_cast<Word>(0) : 0)
+    {
+        clearPadding();
+    }
+
+    template<typename Allocator>
+    explicit BitMatrix(const Matrix<bool, Allocator>& other):
+        BitMatrix(other.width(), other.height())
+    {
+        for (Point p : matrixRange(other)) {
+            if (other[p]) {
+                set(p);
+            }
+        }
+    }
+
+    reference operator[](Point p) {
+        assert(isInsideMatrix(*this, p));
+        return reference{data_[wordIndex(p)], bitMask(p.x)};
+    }
+    bool operator[](Point p) const {
+        assert(isInsideMatrix(*this, p));
+        return (data_[wordIndex(p)] & bitMask(p.x)) != 0;
+    }
+    void set(Point p, bool value = true) {
+        (*this)[p] = value;
+    }
+
+    std::size_t size() const { return width_ * height_; }
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    std::size_t wordsPerRow() const { return wordsPerRow_; }
+
+    Word* rowWords(std::size_t y) {
+        return data_.data() + y * wordsPerRow_;
+    }
+    const Word* rowWords(std::size_t y) const {
+        return data_.data() + y * wordsPerRow_;
+    }
+
+    void reset(std::size_t newWidth, std::size_t newHeight,
+            bool value = false)
+    {
+        width_ = newWidth;
+        height_ = newHeight;
+        wordsPerRow_ = wordCount(width_);
+        data_.resize(wordsPerRow_ * height_);
+        fill(value);
+    }
+    void fill(bool value)
+    {
+        std::fill(data_.begin(), data_.end(),
+                value ? ~static_cast<Word>(0) : 0);
+        clearPadding();
+    }
+    void clear()
+    {
+        data_.clear();
+        width_ = 0;
+        height_ = 0;
+        wordsPerRow_ = 0;
+    }
+
+    BitMatrix& operator&=(const BitMatrix& other) {
+        return combine(other, [](Word a, Word b) { return a & b; });
+    }
+    BitMatrix& operator|=(const BitMatrix& other) {
+        return combine(other, [](Word a, Word b) { return a | b; });
+    }
+    BitMatrix& operator^=(const BitMatrix& other) {
+        return combine(other, [](Word a, Word b) { return a ^ b; });
+    }
+    // this &= ~other
+    BitMatrix& subtract(const BitMatrix& other) {
+        return combine(other, [](Word a, Word b) { return a & ~b; });
+    }
+    BitMatrix& flip() {
+        for (Word& word : data_) {
+            word = ~word;
+        }
+        clearPadding();
+        return *this;
+    }
+
+    std::size_t count() const {
+        std::size_t result = 0;
+        for (Word word : data_) {
+            result += __builtin_popcountll(word);
+        }
+        return result;
+    }
+
+    std::size_t countRow(std::size_t y) const {
+        assert(y < height_);
+        const Word* words = rowWords(y);
+        std::size_t result = 0;
+        for (std::size_t i = 0; i < wordsPerRow_; ++i) {
+            result += __builtin_popcountll(words[i]);
+        }
+        return result;
+    }
+
+    // The first set bit at or after from, in row-major order.
+    boost::optional<Point> findNext(Point from) const {
+        if (from.y < 0 || from.x < 0) {
+            from = Point{0, std::max(from.y, 0)};
+        }
+        if (from.x >= static_cast<int>(width_)) {
+            from = Point{0, from.y + 1};
+        }
+        if (from.y >= static_cast<int>(height_) || width_ == 0) {
+            return boost::none;
+        }
+        std::size_t index = wordIndex(from);
+        Word word = data_[index] &
+                (~static_cast<Word>(0) << (from.x % wordBits));
+        while (word == 0) {
+            if (++index == data_.size()) {
+                return boost::none;
+            }
+            word = data_[index];
+        }
+        return Point(static_cast<int>((index % wordsPerRow_) * wordBits +
+                        __builtin_ctzll(word)),
+                static_cast<int>(index / wordsPerRow_));
+    }
+
+    // Calls function(Point) for every set bit, in row-major order.
+    template<typename Function>
+    void forEachSet(Function function) const {
+        for (std::size_t index = 0; index < data_.size(); ++index) {
+            Word word = data_[index];
+            while (word != 0) {
+                function(Point(static_cast<int>(
+                                (index % wordsPerRow_) * wordBits +
+                                __builtin_ctzll(word)),
+                        static_cast<int>(index / wordsPerRow_)));
+                word &= word - 1;
+            }
+        }
+    }
+
+    // Returns a matrix of the same size where result[p + offset] == (*this)[p].
+    // Bits shifted outside of the matrix are lost; vacated bits are zero.
+    BitMatrix shifted(Point offset) const {
+        BitMatrix result{width_, height_};
+        if (static_cast<std::size_t>(std::abs(offset.x)) >= width_ ||
+                static_cast<std::size_t>(std::abs(offset.y)) >= height_) {
+            return result;
+        }
+        std::size_t wordShift = std::abs(offset.x) / wordBits;
+        std::size_t bitShift = std::abs(offset.x) % wordBits;
+        int words = static_cast<int>(wordsPerRow_);
+        for (int y = std::max(0, -offset.y);
+                y < std::min(static_cast<int>(height_),
+                        static_cast<int>(height_) - offset.y); ++y) {
+            const Word* source = rowWords(y);
+            Word* target = result.rowWords(y + offset.y);
+            auto sourceWord = [&](int i) {
+                return i >= 0 && i < words ? source[i] : 0;
+            };
+            for (int i = 0; i < words; ++i) {
+                if (offset.x >= 0) {
+                    int j = i - static_cast<int>(wordShift);
+                    target[i] = sourceWord(j) << bitShift;
+                    if (bitShift != 0) {
+                        target[i] |= sourceWord(j - 1) >> (wordBits - bitShift);
+                    }
+                } else {
+                    int j = i + static_cast<int>(wordShift);
+                    target[i] = sourceWord(j) >> bitShift;
+                    if (bitShift != 0) {
+                        target[i] |= sourceWord(j + 1) << (wordBits - bitShift);
+                    }
+                }
+            }
+        }
+        result.clearPadding();
+        return result;
+    }
+
+    Matrix<bool> toMatrix() const {
+        Matrix<bool> result{width_, height_};
+        forEachSet([&result](Point p) { result[p] = true; });
+        return result;
+    }
+
+    bool operator==(const BitMatrix& other) const
+    {
+        return width_ == other.width_ && height_ == other.height_
+                && data_ == other.data_;
+    }
+};
+
+inline bool operator!=(const BitMatrix& lhs, const BitMatrix& rhs) {
+    return !(lhs == rhs);
+}
+
+inline BitMatrix operator&(BitMatrix lhs, const BitMatrix& rhs) {
+    return lhs &= rhs;
+}
+
+inline BitMatrix operator|(BitMatrix lhs, const BitMatrix& rhs) {
+    return lhs |= rhs;
+}
+
+inline BitMatrix operator^(BitMatrix lhs, const BitMatrix& rhs) {
+    return lhs ^= rhs;
+}
+
+inline BitMatrix operator~(BitMatrix matrix) {
+    return matrix.flip();
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_BITMATRIX_HPP
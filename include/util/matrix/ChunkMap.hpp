@@ -0,0 +1,116 @@
+#ifndef UTIL_MATRIX_CHUNKMAP_HPP
+#define UTIL_MATRIX_CHUNKMAP_HPP
+
+#include "Matrix.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace util {
+namespace matrix {
+
+// Square chunks of chunkSize x chunkSize cells in a hash map, keyed by chunk
+// coordinates. Any Point, including negative ones, belongs to exactly one
+// chunk. Cells of chunks that are not stored have the default value.
+// Existing chunks are never moved when new ones are added.
+template<typename T, std::size_t chunkSize>
+class ChunkMap {
+    static_assert(chunkSize != 0, "Chunk size must not be zero.");
+public:
+    typedef Matrix<T> Chunk;
+    typedef typename Chunk::reference reference;
+    typedef typename Chunk::const_reference const_reference;
+private:
+    std::unordered_map<Point, Chunk> chunks_;
+    T defaultValue_;
+
+    static int floorDivide(int value) {
+        constexpr int size = chunkSize;
+        return value >= 0 ? value / size : -((-(value + 1)) / size) - 1;
+    }
+
+    static int floorModulo(int value) {
+        constexpr int size = chunkSize;
+        int result = value % size;
+        return result < 0 ? result + size : result;
+    }
+
+public:
+    explicit ChunkMap(const T& defaultValue = T()):
+        defaultValue_(defaultValue)
+    {}
+
+    // The coordinates of the chunk containing p.
+    static Point chunkOf(Point p) {
+        return Point{floorDivide(p.x), floorDivide(p.y)};
+    }
+    // The position of p inside its chunk.
+    static Point offsetIn(Point p) {
+        return Point{floorModulo(p.x), floorModulo(p.y)};
+    }
+    // The first cell of the chunk. It does not fit in an int for the
+    // outermost chunks if chunkSize is not a power of two.
+    static Point chunkOrigin(Point chunk) {
+        return chunk * static_cast<int>(chunkSize);
+    }
+
+    const T& defaultValue() const { return defaultValue_; }
+
+    const_reference get(Point p) const {
+        const Chunk* chunk = findChunk(chunkOf(p));
+        return chunk ? (*chunk)[offsetIn(p)] : defaultValue_;
+    }
+
+    // Creates the chunk if needed.
+    reference get(Point p) {
+        return chunk(chunkOf(p))[offsetIn(p)];
+    }
+
+    const Chunk* findChunk(Point chunk) const {
+        auto iterator = chunks_.find(chunk);
+        return iterator == chunks_.end() ? nullptr : &iterator->second;
+    }
+    Chunk* findChunk(Point chunk) {
+        auto iterator = chunks_.find(chunk);
+        return iterator == chunks_.end() ? nullptr : &iterator->second;
+    }
+
+    // Creates the chunk filled with the default value if needed.
+    Chunk& chunk(Point chunk) {
+        auto iterator = chunks_.find(chunk);
+        if (iterator == chunks_.end()) {
+            iterator = chunks_.emplace(chunk,
+                    Chunk{chunkSize, chunkSize, defaultValue_}).first;
+        }
+        return iterator->second;
+    }
+
+    std::size_t chunkCount() const { return chunks_.size(); }
+
+    // Calls function(chunkCoordinates, chunk) for every stored chunk, in no
+    // particular order.
+    template<typename Function>
+    void forEachChunk(Function function) const {
+        for (const auto& element : chunks_) {
+            function(element.first, element.second);
+        }
+    }
+
+    // Removes the chunks that only contain the default value.
+    void compact() {
+        for (auto iterator = chunks_.begin(); iterator != chunks_.end(); ) {
+            bool isDefault = std::all_of(iterator->second.begin(),
+                    iterator->second.end(), [this](const T& value) {
+                        return value == defaultValue_;
+                    });
+            iterator = isDefault ? chunks_.erase(iterator) : ++iterator;
+        }
+    }
+
+    void clear() { chunks_.clear(); }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_CHUNKMAP_HPP
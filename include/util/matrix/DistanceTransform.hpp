@@ -0,0 +1,289 @@
+#ifndef UTIL_MATRIX_DISTANCETRANSFORM_HPP
+#define UTIL_MATRIX_DISTANCETRANSFORM_HPP
+
+#include "GridSearcher.hpp"
+#include "Matrix.hpp"
+#include "MatrixKernels.hpp"
+#include "ParallelAlgorithms.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+// Distance transforms: for every cell, the distance to the nearest feature
+// cell, i.e. a cell where input[p] is true. The input can be any matrix of
+// values convertible to bool, like Matrix<bool> or BitMatrix. If there are no
+// feature cells at all, every distance is the maximum value of the result
+// type.
+//
+// The square metrics are separable and take two passes in O(cells): the
+// distance to the nearest feature in the same column is computed first, in
+// strips of columns, then each row takes the lower envelope of the column
+// results (Felzenszwalb and Huttenlocher for Euclidean distance, with the
+// separators of Meijster et al. for the others). The ThreadPool overloads run
+// both passes in bands on the pool.
+
+namespace util {
+namespace matrix {
+
+namespace detail {
+
+inline long floorDivide(long value, long divisor) {
+    long result = value / divisor;
+    return result * divisor > value ? result - 1 : result;
+}
+
+// A metric for the row pass. f(x, i, g) is the distance of x from the column
+// at i whose nearest feature is g rows away. sep(i, u, gi, gu) is the last x
+// where column i is at least as near as column u > i.
+struct ManhattanMetric {
+    static long f(long x, long i, long g) { return std::abs(x - i) + g; }
+    static long sep(long i, long u, long gi, long gu) {
+        if (gu >= gi + u - i) {
+            return std::numeric_limits<int>::max();
+        }
+        if (gi > gu + u - i) {
+            return std::numeric_limits<int>::min();
+        }
+        return floorDivide(gu - gi + u + i, 2);
+    }
+};
+
+struct ChebyshevMetric {
+    static long f(long x, long i, long g) {
+        return std::max(std::abs(x - i), g);
+    }
+    static long sep(long i, long u, long gi, long gu) {
+        if (gi <= gu) {
+            return std::max(i + gu, floorDivide(i + u, 2));
+        }
+        return std::min(u - gi, floorDivide(i + u, 2));
+    }
+};
+
+struct EuclideanSquareMetric {
+    static long f(long x, long i, long g) { return (x - i) * (x - i) + g * g; }
+    static long sep(long i, long u, long gi, long gu) {
+        return floorDivide(u * u - i * i + gu * gu - gi * gi, 2 * (u - i));
+    }
+};
+
+// Vertical distances of columns [begin, end) to the nearest feature in the
+// same column, or infinity.
+template<typename Input>
+void columnDistances(const Input& input, Matrix<int>& distances,
+        std::size_t begin, std::size_t end, int infinity) {
+    std::size_t height = input.height();
+    int* previous = nullptr;
+    for (std::size_t y = 0; y < height; ++y) {
+        int* row = distances.data() + y * distances.stride();
+        for (std::size_t x = begin; x < end; ++x) {
+            Point p(x, y);
+            row[x] = input[p] ? 0 :
+                    previous ? std::min(previous[x] + 1, infinity) : infinity;
+        }
+        previous = row;
+    }
+    for (std::size_t y = height - 1; y-- > 0;) {
+        int* row = distances.data() + y * distances.stride();
+        const int* next = row + distances.stride();
+        for (std::size_t x = begin; x < end; ++x) {
+            row[x] = std::min(row[x], next[x] + 1);
+        }
+    }
+}
+
+// The lower envelope of the columns of one row, see Meijster, Roerdink and
+// Hesselink: "A general algorithm for computing distance transforms in linear
+// time".
+template<typename Metric, typename Result>
+void rowDistances(const int* column, Result* out, long width,
+        std::vector<long>& starts, std::vector<long>& sources) {
+    starts.resize(width);
+    sources.resize(width);
+    long q = 0;
+    sources[0] = 0;
+    starts[0] = 0;
+    for (long u = 1; u < width; ++u) {
+        while (q >= 0 && Metric::f(starts[q], sources[q], column[sources[q]]) >
+                Metric::f(starts[q], u, column[u])) {
+            --q;
+        }
+        if (q < 0) {
+            q = 0;
+            sources[0] = u;
+        } else {
+            long start = 1 + Metric::sep(sources[q], u, column[sources[q]],
+                    column[u]);
+            if (start < width) {
+                ++q;
+                sources[q] = u;
+                starts[q] = start;
+            }
+        }
+    }
+    for (long u = width - 1; u >= 0; --u) {
+        out[u] = static_cast<Result>(Metric::f(u, sources[q],
+                column[sources[q]]));
+        if (u == starts[q]) {
+            --q;
+        }
+    }
+}
+
+template<typename Metric, typename Result, typename Input,
+        typename ForColumns, typename ForRows>
+Matrix<Result> separableDistanceTransform(const Input& input,
+        ForColumns forColumns, ForRows forRows) {
+    std::size_t width = input.width();
+    std::size_t height = input.height();
+    Matrix<Result> result{width, height};
+    if (width == 0 || height == 0) {
+        return result;
+    }
+    // Larger than any real distance, and small enough not to overflow in the
+    // metrics.
+    int infinity = width + height;
+    Matrix<int> columns{width, height};
+    forColumns([&](std::size_t begin, std::size_t end) {
+            columnDistances(input, columns, begin, end, infinity);
+        });
+    if (std::all_of(columns.data(), columns.data() + width,
+            [infinity](int value) { return value == infinity; })) {
+        result.fill(std::numeric_limits<Result>::max());
+        return result;
+    }
+    forRows([&](std::size_t begin, std::size_t end) {
+            std::vector<long> starts;
+            std::vector<long> sources;
+            for (std::size_t y = begin; y < end; ++y) {
+                rowDistances<Metric>(
+                        columns.data() + y * columns.stride(),
+                        result.data() + y * result.stride(), width,
+                        starts, sources);
+            }
+        });
+    return result;
+}
+
+template<typename Metric, typename Result, typename Input>
+Matrix<Result> separableDistanceTransform(const Input& input) {
+    auto all = [](std::size_t size) {
+        return [size](auto function) { function(0, size); };
+    };
+    return separableDistanceTransform<Metric, Result>(input,
+            all(input.width()), all(input.height()));
+}
+
+template<typename Metric, typename Result, typename Input>
+Matrix<Result> separableDistanceTransform(ThreadPool& threadPool,
+        const Input& input, std::size_t grain) {
+    auto bands = [&threadPool, grain](std::size_t size) {
+        return [&threadPool, grain, size](auto function) {
+            parallelForBands(threadPool, size, grain, function);
+        };
+    };
+    return separableDistanceTransform<Metric, Result>(input,
+            bands(input.width()), bands(input.height()));
+}
+
+template<typename Result>
+Matrix<Result> squareRoot(Matrix<long>&& squares) {
+    Matrix<Result> result{squares.width(), squares.height()};
+    kernels::transform(squares, result, [](long value) {
+            return value == std::numeric_limits<long>::max() ?
+                    std::numeric_limits<Result>::max() :
+                    static_cast<Result>(std::sqrt(static_cast<double>(value)));
+        });
+    return result;
+}
+
+} // namespace detail
+
+// Matches distance().
+template<typename Result = int, typename Input>
+Matrix<Result> manhattanDistanceTransform(const Input& input) {
+    return detail::separableDistanceTransform<detail::ManhattanMetric,
+            Result>(input);
+}
+
+template<typename Result = int, typename Input>
+Matrix<Result> manhattanDistanceTransform(ThreadPool& threadPool,
+        const Input& input, std::size_t grain = 0) {
+    return detail::separableDistanceTransform<detail::ManhattanMetric,
+            Result>(threadPool, input, grain);
+}
+
+// Matches chebyshevDistance().
+template<typename Result = int, typename Input>
+Matrix<Result> chebyshevDistanceTransform(const Input& input) {
+    return detail::separableDistanceTransform<detail::ChebyshevMetric,
+            Result>(input);
+}
+
+template<typename Result = int, typename Input>
+Matrix<Result> chebyshevDistanceTransform(ThreadPool& threadPool,
+        const Input& input, std::size_t grain = 0) {
+    return detail::separableDistanceTransform<detail::ChebyshevMetric,
+            Result>(threadPool, input, grain);
+}
+
+// Exact; matches distanceSquare().
+template<typename Result = long, typename Input>
+Matrix<Result> euclideanSquareDistanceTransform(const Input& input) {
+    return detail::separableDistanceTransform<detail::EuclideanSquareMetric,
+            Result>(input);
+}
+
+template<typename Result = long, typename Input>
+Matrix<Result> euclideanSquareDistanceTransform(ThreadPool& threadPool,
+        const Input& input, std::size_t grain = 0) {
+    return detail::separableDistanceTransform<detail::EuclideanSquareMetric,
+            Result>(threadPool, input, grain);
+}
+
+// The square root of euclideanSquareDistanceTransform().
+template<typename Result = float, typename Input>
+Matrix<Result> euclideanDistanceTransform(const Input& input) {
+    return detail::squareRoot<Result>(
+            euclideanSquareDistanceTransform<long>(input));
+}
+
+template<typename Result = float, typename Input>
+Matrix<Result> euclideanDistanceTransform(ThreadPool& threadPool,
+        const Input& input, std::size_t grain = 0) {
+    return detail::squareRoot<Result>(
+            euclideanSquareDistanceTransform<long>(threadPool, input, grain));
+}
+
+// Matches hex::distance(). Hex distance is not separable in the offset
+// coordinates of the matrix, so this is a breadth-first search from every
+// feature cell at once, which is O(cells) but sequential.
+template<typename Result = int, typename Input>
+Matrix<Result> hexDistanceTransform(const Input& input) {
+    Matrix<Result> result{input.width(), input.height(),
+            std::numeric_limits<Result>::max()};
+    std::vector<Point> features;
+    for (Point p : matrixRange(result)) {
+        if (input[p]) {
+            features.push_back(p);
+        }
+    }
+    if (features.empty()) {
+        return result;
+    }
+    GridSearcher<HexNeighborhood> searcher{input.width(), input.height()};
+    searcher.bfs(features, [](Point) { return true; },
+            [&result](Point p, int distance) {
+                result[p] = distance;
+                return true;
+            });
+    return result;
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_DISTANCETRANSFORM_HPP
@@ -24,8 +24,8 @@ struct ToString {
     }
 };
 
-template<typename T, typename Converter = ToString>
-void dumpMatrix(std::ostream& file, const Matrix<T>& table,
+template<typename MatrixType, typename Converter = ToString>
+void dumpMatrix(std::ostream& file, const MatrixType& table,
         const std::string& title = "", int indent = 0,
         const Converter& converter = Converter{}) {
     std::string indentString(indent, ' ');
@@ -0,0 +1,159 @@
+#ifndef UTIL_MATRIX_GRIDSEARCHER_HPP
+#define UTIL_MATRIX_GRIDSEARCHER_HPP
+
+#include "Matrix.hpp"
+#include "Neighborhoods.hpp"
+
+#include <assert.h>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace util {
+namespace matrix {
+
+// Breadth-first search over a width x height grid that can be run many times
+// without allocating or clearing anything.
+//
+// The visited state is a matrix of generation stamps: a cell is visited in
+// the current search if its stamp equals the current generation, so starting
+// a new search only increments the generation. The queue is allocated once
+// with room for every cell; as each cell is queued at most once per search,
+// it never has to grow or wrap around.
+//
+// Cells are passable if passable(p) is true. Start cells are always visited.
+// The neighbors are taken from Neighborhood (see Neighborhoods.hpp).
+template<typename Neighborhood = SquareNeighborhood>
+class GridSearcher {
+public:
+    static constexpr int unlimited = std::numeric_limits<int>::max();
+
+private:
+    Neighborhood neighborhood_;
+    Matrix<std::uint32_t> visited_;
+    std::uint32_t generation_ = 0;
+    std::vector<Point> queue_;
+    std::size_t queueEnd_ = 0;
+
+    void nextGeneration() {
+        if (++generation_ == 0) {
+            visited_.fill(0);
+            generation_ = 1;
+        }
+        queueEnd_ = 0;
+    }
+
+    bool tryVisit(Point p) {
+        std::uint32_t& stamp = visited_[p];
+        if (stamp == generation_) {
+            return false;
+        }
+        stamp = generation_;
+        queue_[queueEnd_++] = p;
+        return true;
+    }
+
+    template<typename Passable, typename Visitor>
+    bool run(Passable& passable, Visitor& visitor, int maxDistance) {
+        std::size_t levelEnd = queueEnd_;
+        int distance = 0;
+        for (std::size_t current = 0; current < queueEnd_; ++current) {
+            if (current == levelEnd) {
+                ++distance;
+                levelEnd = queueEnd_;
+            }
+            Point p = queue_[current];
+            if (!visitor(p, distance)) {
+                return true;
+            }
+            if (distance == maxDistance) {
+                continue;
+            }
+            for (Point offset : neighborhood_.offsets(p)) {
+                Point neighbor = p + offset;
+                if (isInsideMatrix(visited_, neighbor) &&
+                        visited_[neighbor] != generation_ &&
+                        passable(neighbor)) {
+                    tryVisit(neighbor);
+                }
+            }
+        }
+        return false;
+    }
+
+public:
+    GridSearcher() = default;
+
+    GridSearcher(std::size_t width, std::size_t height,
+            const Neighborhood& neighborhood = Neighborhood()):
+        neighborhood_(neighborhood)
+    {
+        resize(width, height);
+    }
+
+    std::size_t width() const { return visited_.width(); }
+    std::size_t height() const { return visited_.height(); }
+
+    // Invalidates the result of the last search.
+    void resize(std::size_t width, std::size_t height) {
+        visited_.reset(width, height, 0);
+        generation_ = 0;
+        queue_.resize(width * height);
+        queueEnd_ = 0;
+    }
+
+    // Visits the cells reachable from start in order of their distance,
+    // calling visitor(p, distance) for each of them, including start with
+    // distance 0. The search stops early if the visitor returns false; the
+    // return value is true in that case. Cells farther than maxDistance are
+    // not visited.
+    template<typename Passable, typename Visitor>
+    bool bfs(Point start, Passable passable, Visitor visitor,
+            int maxDistance = unlimited) {
+        assert(isInsideMatrix(visited_, start));
+        nextGeneration();
+        tryVisit(start);
+        return run(passable, visitor, maxDistance);
+    }
+
+    // The same with several start cells, all at distance 0.
+    template<typename Passable, typename Visitor>
+    bool bfs(const std::vector<Point>& starts, Passable passable,
+            Visitor visitor, int maxDistance = unlimited) {
+        nextGeneration();
+        for (Point start : starts) {
+            assert(isInsideMatrix(visited_, start));
+            tryVisit(start);
+        }
+        return run(passable, visitor, maxDistance);
+    }
+
+    // Calls visitor(p) for every cell reachable from start, in breadth-first
+    // order.
+    template<typename Passable, typename Visitor>
+    void floodFill(Point start, Passable passable, Visitor visitor) {
+        bfs(start, passable, [&visitor](Point p, int /*distance*/) {
+                visitor(p);
+                return true;
+            });
+    }
+
+    // Whether p was visited by the last search.
+    bool isVisited(Point p) const {
+        return visited_[p] == generation_ && generation_ != 0;
+    }
+
+    // The cells visited by the last search, in the order they were visited.
+    // Cells queued before an early exit are included, even if they were not
+    // passed to the visitor.
+    const Point* visitedBegin() const { return queue_.data(); }
+    const Point* visitedEnd() const { return queue_.data() + queueEnd_; }
+};
+
+template<typename Neighborhood>
+constexpr int GridSearcher<Neighborhood>::unlimited;
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_GRIDSEARCHER_HPP
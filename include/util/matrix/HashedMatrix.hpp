@@ -0,0 +1,132 @@
+#ifndef UTIL_MATRIX_HASHEDMATRIX_HPP
+#define UTIL_MATRIX_HASHEDMATRIX_HPP
+
+#include "Matrix.hpp"
+#include "MatrixHash.hpp"
+#include "WriteProxy.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <assert.h>
+#include <cstdint>
+
+namespace util {
+namespace matrix {
+
+// A matrix that keeps its hash up to date on every write, in constant time.
+// The hash is the XOR of a per-cell hash computed from the index and the
+// value of the cell, like a Zobrist hash with the random table replaced by a
+// mixing function, so it works for any value type hashable with boost::hash.
+// Writes go through set() or the proxy returned by operator[].
+//
+// The hash is not compatible with hashMatrix().
+template<typename T>
+class HashedMatrix {
+    Matrix<T> matrix_;
+    std::uint64_t hash_ = 0;
+
+    static std::uint64_t cellHash(std::size_t index, const T& value) {
+        return splitMix64(splitMix64(index) + boost::hash<T>{}(value));
+    }
+
+    static std::uint64_t sizeHash(std::size_t width, std::size_t height) {
+        return splitMix64(splitMix64(width) ^ height);
+    }
+
+    void rehash() {
+        hash_ = sizeHash(matrix_.width(), matrix_.height());
+        for (std::size_t i = 0; i < matrix_.size(); ++i) {
+            hash_ ^= cellHash(i, matrix_[i]);
+        }
+    }
+
+public:
+    typedef T valueType;
+    typedef WriteProxy<HashedMatrix> reference;
+    typedef typename Matrix<T>::const_reference const_reference;
+    typedef typename Matrix<T>::const_iterator const_iterator;
+
+    HashedMatrix() { rehash(); }
+
+    HashedMatrix(std::size_t width, std::size_t height,
+            const T& defValue = T()):
+        matrix_(width, height, defValue)
+    {
+        rehash();
+    }
+
+    explicit HashedMatrix(Matrix<T> matrix): matrix_(std::move(matrix)) {
+        rehash();
+    }
+
+    reference operator[](Point p) {
+        assert(isInsideMatrix(*this, p));
+        return reference{*this, p};
+    }
+    const_reference operator[](Point p) const {
+        return matrix_[p];
+    }
+
+    void set(Point p, const T& value) {
+        assert(isInsideMatrix(*this, p));
+        std::size_t index = p.y * matrix_.width() + p.x;
+        hash_ ^= cellHash(index, matrix_[index]) ^ cellHash(index, value);
+        matrix_[index] = value;
+    }
+
+    std::uint64_t hash() const { return hash_; }
+    const Matrix<T>& matrix() const { return matrix_; }
+
+    const T* data() const { return matrix_.data(); }
+    std::size_t size() const { return matrix_.size(); }
+    std::size_t width() const { return matrix_.width(); }
+    std::size_t height() const { return matrix_.height(); }
+    std::size_t stride() const { return matrix_.stride(); }
+
+    void reset(std::size_t newWidth, std::size_t newHeight,
+            const T& defValue = T()) {
+        matrix_.reset(newWidth, newHeight, defValue);
+        rehash();
+    }
+    void fill(const T& value) {
+        matrix_.fill(value);
+        rehash();
+    }
+    void clear() {
+        matrix_.clear();
+        rehash();
+    }
+
+    // Different hashes mean different matrices, so the cells are only
+    // compared if the hashes are equal.
+    bool operator==(const HashedMatrix& other) const {
+        return hash_ == other.hash_ && matrix_ == other.matrix_;
+    }
+
+    const_iterator begin() const { return matrix_.begin(); }
+    const_iterator end() const { return matrix_.end(); }
+    const_iterator cbegin() const { return matrix_.cbegin(); }
+    const_iterator cend() const { return matrix_.cend(); }
+};
+
+template<typename T>
+inline bool operator!=(const HashedMatrix<T>& lhs,
+        const HashedMatrix<T>& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace matrix
+} // namespace util
+
+namespace std {
+
+template<typename T>
+struct hash<util::matrix::HashedMatrix<T>> {
+    size_t operator()(const util::matrix::HashedMatrix<T>& matrix) const {
+        return matrix.hash();
+    }
+};
+
+} // namespace std
+
+#endif // UTIL_MATRIX_HASHEDMATRIX_HPP
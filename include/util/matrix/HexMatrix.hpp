@@ -5,6 +5,7 @@
 #include "Matrix.hpp"
 #include "Neighbors.hpp"
 
+#include <cstdlib>
 #include <istream>
 #include <ostream>
 
@@ -12,8 +13,8 @@ namespace util {
 namespace matrix {
 namespace hex {
 
-template<typename T>
-void printMatrix(std::ostream& os, const Matrix<T>& matrix) {
+template<typename T, typename Allocator>
+void printMatrix(std::ostream& os, const Matrix<T, Allocator>& matrix) {
     os << "   ";
     for (int x = 0; x < static_cast<int>(matrix.width()); ++x) {
         os << std::setw(3) << x % 100;
@@ -52,6 +53,19 @@ constexpr const Neighbors& getNeighbors(Point p) {
     return p.x % 2 == 0 ? evenNeighbors : oddNeighbors;
 }
 
+// The number of steps between the points on the hex grid.
+inline int distance(Point p1, Point p2) {
+    // Convert to axial coordinates. Odd columns are shifted down by half a
+    // cell, see getNeighbors().
+    int q1 = p1.x;
+    int r1 = p1.y - (p1.x - (p1.x & 1)) / 2;
+    int q2 = p2.x;
+    int r2 = p2.y - (p2.x - (p2.x & 1)) / 2;
+    int dq = q1 - q2;
+    int dr = r1 - r2;
+    return (std::abs(dq) + std::abs(dr) + std::abs(dq + dr)) / 2;
+}
+
 } // namespace hex
 } // namespace matrix
 } // namespace util
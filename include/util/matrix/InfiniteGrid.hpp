@@ -0,0 +1,141 @@
+#ifndef UTIL_MATRIX_INFINITEGRID_HPP
+#define UTIL_MATRIX_INFINITEGRID_HPP
+
+#include "ChunkMap.hpp"
+#include "Matrix.hpp"
+#include "PointRange.hpp"
+
+#include <algorithm>
+#include <climits>
+
+namespace util {
+namespace matrix {
+
+// A grid without bounds: any Point is valid, including negative ones. It
+// grows one chunkSize x chunkSize chunk at a time when a cell outside the
+// allocated chunks is written, without moving existing chunks. Cells that
+// were never written have the default value.
+//
+// The non-const operator[] allocates the chunk of the cell, so read through
+// a const reference or get() to avoid that.
+template<typename T, std::size_t chunkSize = 32>
+class InfiniteGrid {
+    typedef ChunkMap<T, chunkSize> Chunks;
+    Chunks chunks_;
+    // The bounding box of the allocated chunks, in chunk coordinates.
+    Point minChunk_{INT_MAX, INT_MAX};
+    Point maxChunk_{INT_MIN, INT_MIN};
+
+    void addToBoundingBox(Point chunk) {
+        minChunk_.x = std::min(minChunk_.x, chunk.x);
+        minChunk_.y = std::min(minChunk_.y, chunk.y);
+        maxChunk_.x = std::max(maxChunk_.x, chunk.x);
+        maxChunk_.y = std::max(maxChunk_.y, chunk.y);
+    }
+
+    void resetBoundingBox() {
+        minChunk_ = Point{INT_MAX, INT_MAX};
+        maxChunk_ = Point{INT_MIN, INT_MIN};
+    }
+
+    // The first cell of the chunk, clamped to the range of int.
+    static int clampedChunkOrigin(long long chunk) {
+        long long origin = chunk * static_cast<long long>(chunkSize);
+        return static_cast<int>(std::min<long long>(
+                std::max<long long>(origin, INT_MIN), INT_MAX));
+    }
+
+public:
+    typedef T valueType;
+    typedef typename Chunks::reference reference;
+    typedef typename Chunks::const_reference const_reference;
+    typedef typename Chunks::Chunk Chunk;
+
+    explicit InfiniteGrid(const T& defValue = T()): chunks_(defValue) {}
+
+    reference operator[](Point p) {
+        std::size_t chunkCount = chunks_.chunkCount();
+        reference result = chunks_.get(p);
+        if (chunks_.chunkCount() != chunkCount) {
+            addToBoundingBox(Chunks::chunkOf(p));
+        }
+        return result;
+    }
+    const_reference operator[](Point p) const {
+        return chunks_.get(p);
+    }
+    const_reference get(Point p) const {
+        return chunks_.get(p);
+    }
+
+    const T& defaultValue() const { return chunks_.defaultValue(); }
+    std::size_t chunkCount() const { return chunks_.chunkCount(); }
+
+    // The area covered by the allocated chunks. It is empty if nothing has
+    // been written yet. The end is clamped to INT_MAX, so the cells at
+    // x == INT_MAX or y == INT_MAX are never inside it.
+    PointRange boundingBox() const {
+        if (chunks_.chunkCount() == 0) {
+            return PointRange{p00, p00};
+        }
+        return PointRange{
+                Point{clampedChunkOrigin(minChunk_.x),
+                        clampedChunkOrigin(minChunk_.y)},
+                Point{clampedChunkOrigin(maxChunk_.x + 1LL),
+                        clampedChunkOrigin(maxChunk_.y + 1LL)}};
+    }
+
+    // Calls function(origin, chunk) for every allocated chunk, in no
+    // particular order. origin is the position of the first cell of the
+    // chunk.
+    template<typename Function>
+    void forEachChunk(Function function) const {
+        chunks_.forEachChunk([&function](Point chunk, const Chunk& data) {
+                    function(Chunks::chunkOrigin(chunk), data);
+                });
+    }
+
+    // Frees the chunks that only contain the default value and shrinks the
+    // bounding box accordingly.
+    void compact() {
+        chunks_.compact();
+        resetBoundingBox();
+        chunks_.forEachChunk([this](Point chunk, const Chunk&) {
+                    addToBoundingBox(chunk);
+                });
+    }
+
+    void clear() {
+        chunks_.clear();
+        resetBoundingBox();
+    }
+
+    // A copy of the cells in range. result[p] == grid[range.front() + p].
+    Matrix<T> toMatrix(const PointRange& range) const {
+        Point origin = range.beginPoint();
+        Point size = range.endPoint() - origin;
+        if (range.empty()) {
+            return Matrix<T>{};
+        }
+        Matrix<T> result{static_cast<std::size_t>(size.x),
+                static_cast<std::size_t>(size.y), defaultValue()};
+        forEachChunk([&](Point chunkOrigin, const Chunk& chunk) {
+                    for (Point p : matrixRange(chunk)) {
+                        Point target = chunkOrigin + p - origin;
+                        if (isInsideMatrix(result, target)) {
+                            result[target] = chunk[p];
+                        }
+                    }
+                });
+        return result;
+    }
+
+    Matrix<T> toMatrix() const {
+        return toMatrix(boundingBox());
+    }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_INFINITEGRID_HPP
@@ -0,0 +1,414 @@
+#ifndef UTIL_MATRIX_JUMPPOINTSEARCH_HPP
+#define UTIL_MATRIX_JUMPPOINTSEARCH_HPP
+
+#include "BitMatrix.hpp"
+#include "PathFinding.hpp"
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+// Jump Point Search over uniform cost grids. The passability of the cells is
+// given by a matrix of bools or a BitMatrix (true means passable). Every step
+// costs 1, including diagonal ones, so the costs are the same as those of
+// PathFinder with a cost of 1 for every passable cell.
+//
+// Instead of expanding every cell, the search jumps along straight lines
+// (and diagonals on 8-connected grids) until it finds a cell where an optimal
+// path may have to turn, and only those cells are put into the queue. The
+// paths follow a canonical order: on 8-connected grids diagonal steps come
+// first, on 4-connected grids vertical ones. Corners of impassable cells are
+// never cut.
+//
+// Horizontal jumps scan whole words of a BitMatrix at a time.
+
+namespace util {
+namespace matrix {
+
+namespace detail {
+
+// Passability lookups for jump point search. Cells outside the matrix are
+// impassable.
+template<typename Passability>
+class JumpGrid {
+    const Passability& passability_;
+    int width_, height_;
+public:
+    explicit JumpGrid(const Passability& passability):
+        passability_(passability), width_(passability.width()),
+        height_(passability.height())
+    {}
+
+    bool passable(int x, int y) const {
+        return x >= 0 && y >= 0 && x < width_ && y < height_ &&
+                passability_[Point{x, y}];
+    }
+
+    // Moves from (x, y) in direction dx, and returns the x coordinate of the
+    // first cell that is the goal or has a forced neighbor above or below it,
+    // or -1 if an impassable cell is reached first.
+    int jumpRow(int x, int y, int dx, Point goal) const {
+        for (x += dx; passable(x, y); x += dx) {
+            if ((x == goal.x && y == goal.y) ||
+                    (passable(x, y - 1) && !passable(x - dx, y - 1)) ||
+                    (passable(x, y + 1) && !passable(x - dx, y + 1))) {
+                return x;
+            }
+        }
+        return -1;
+    }
+};
+
+template<>
+class JumpGrid<BitMatrix> {
+    typedef BitMatrix::Word Word;
+    static constexpr int wordBits = BitMatrix::wordBits;
+
+    const BitMatrix& passability_;
+    int width_, height_, wordsPerRow_;
+
+    const Word* row(int y) const {
+        return y >= 0 && y < height_ ? passability_.rowWords(y) : nullptr;
+    }
+
+    Word word(const Word* words, int index) const {
+        return words && index >= 0 && index < wordsPerRow_ ? words[index] : 0;
+    }
+
+    Word goalBit(Point goal, int y, int index) const {
+        return goal.y == y && goal.x / wordBits == index ?
+                static_cast<Word>(1) << (goal.x % wordBits) : 0;
+    }
+public:
+    explicit JumpGrid(const BitMatrix& passability):
+        passability_(passability), width_(passability.width()),
+        height_(passability.height()),
+        wordsPerRow_(passability.wordsPerRow())
+    {}
+
+    bool passable(int x, int y) const {
+        return x >= 0 && y >= 0 && x < width_ && y < height_ &&
+                passability_[Point{x, y}];
+    }
+
+    // Same as the generic version. A cell stops the jump if it is
+    // impassable, the goal, or passable above (below) while the cell before it
+    // is not; all of these are computed for a word of cells at once. The
+    // padding bits of the rows are zero, so the end of the row is impassable.
+    int jumpRow(int x, int y, int dx, Point goal) const {
+        int start = x + dx;
+        if (start < 0 || start >= width_) {
+            return -1;
+        }
+        const Word* current = row(y);
+        const Word* above = row(y - 1);
+        const Word* below = row(y + 1);
+        int startIndex = start / wordBits;
+        if (dx > 0) {
+            Word mask = ~static_cast<Word>(0) << (start % wordBits);
+            for (int index = startIndex; index < wordsPerRow_; ++index) {
+                Word passable = current[index];
+                Word up = word(above, index);
+                Word down = word(below, index);
+                Word upBefore = (up << 1) |
+                        (word(above, index - 1) >> (wordBits - 1));
+                Word downBefore = (down << 1) |
+                        (word(below, index - 1) >> (wordBits - 1));
+                Word stop = (~passable | (up & ~upBefore) |
+                        (down & ~downBefore) | goalBit(goal, y, index)) & mask;
+                if (stop != 0) {
+                    int bit = __builtin_ctzll(stop);
+                    return (passable >> bit) & 1 ?
+                            index * wordBits + bit : -1;
+                }
+                mask = ~static_cast<Word>(0);
+            }
+        } else {
+            int startBit = start % wordBits;
+            Word mask = startBit == wordBits - 1 ? ~static_cast<Word>(0) :
+                    (static_cast<Word>(1) << (startBit + 1)) - 1;
+            for (int index = startIndex; index >= 0; --index) {
+                Word passable = current[index];
+                Word up = word(above, index);
+                Word down = word(below, index);
+                Word upBefore = (up >> 1) |
+                        (word(above, index + 1) << (wordBits - 1));
+                Word downBefore = (down >> 1) |
+                        (word(below, index + 1) << (wordBits - 1));
+                Word stop = (~passable | (up & ~upBefore) |
+                        (down & ~downBefore) | goalBit(goal, y, index)) & mask;
+                if (stop != 0) {
+                    int bit = wordBits - 1 - __builtin_clzll(stop);
+                    return (passable >> bit) & 1 ?
+                            index * wordBits + bit : -1;
+                }
+                mask = ~static_cast<Word>(0);
+            }
+        }
+        return -1;
+    }
+};
+
+inline int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+} // namespace detail
+
+// Neighborhood is SquareNeighborhood or SquareDiagonalNeighborhood. Like
+// PathFinder, the search state is kept between searches and resized to the
+// passability matrix as needed.
+template<typename Neighborhood>
+class JumpPointSearch {
+    static_assert(std::is_same<Neighborhood, SquareNeighborhood>::value ||
+            std::is_same<Neighborhood, SquareDiagonalNeighborhood>::value,
+            "Jump point search needs a square neighborhood.");
+
+    static constexpr bool diagonal =
+            std::is_same<Neighborhood, SquareDiagonalNeighborhood>::value;
+
+    Matrix<int> reached_;
+    // Open if generation_, closed if generation_ + 1.
+    Matrix<std::uint32_t> state_;
+    Matrix<Point> parents_;
+    std::uint32_t generation_ = 0;
+    detail::RadixHeap queue_;
+    Point start_;
+    Point goal_;
+    bool found_ = false;
+    std::size_t expandedCount_ = 0;
+
+    static int distance(Point p1, Point p2) {
+        return diagonal ? chebyshevDistance(p1, p2) : matrix::distance(p1, p2);
+    }
+
+    std::uint32_t index(Point p) const { return p.y * state_.width() + p.x; }
+    Point point(std::uint32_t index) const {
+        return Point(index % state_.width(), index / state_.width());
+    }
+
+    template<typename Grid>
+    boost::optional<Point> jumpColumn(const Grid& grid, Point p, int dy)
+            const {
+        for (p.y += dy; grid.passable(p.x, p.y); p.y += dy) {
+            if (p == goal_) {
+                return p;
+            }
+            if (diagonal) {
+                if ((grid.passable(p.x - 1, p.y) &&
+                        !grid.passable(p.x - 1, p.y - dy)) ||
+                        (grid.passable(p.x + 1, p.y) &&
+                        !grid.passable(p.x + 1, p.y - dy))) {
+                    return p;
+                }
+            } else if (grid.jumpRow(p.x, p.y, 1, goal_) >= 0 ||
+                    grid.jumpRow(p.x, p.y, -1, goal_) >= 0) {
+                return p;
+            }
+        }
+        return boost::none;
+    }
+
+    template<typename Grid>
+    boost::optional<Point> jumpDiagonal(const Grid& grid, Point p,
+            Point direction) const {
+        while (grid.passable(p.x + direction.x, p.y) &&
+                grid.passable(p.x, p.y + direction.y)) {
+            p += direction;
+            if (!grid.passable(p.x, p.y)) {
+                return boost::none;
+            }
+            if (p == goal_ ||
+                    grid.jumpRow(p.x, p.y, direction.x, goal_) >= 0 ||
+                    jumpColumn(grid, p, direction.y)) {
+                return p;
+            }
+        }
+        return boost::none;
+    }
+
+    // The next jump point from p in direction.
+    template<typename Grid>
+    boost::optional<Point> jump(const Grid& grid, Point p, Point direction)
+            const {
+        if (direction.y == 0) {
+            int x = grid.jumpRow(p.x, p.y, direction.x, goal_);
+            return x >= 0 ? boost::optional<Point>{Point{x, p.y}} :
+                    boost::none;
+        }
+        if (direction.x == 0) {
+            return jumpColumn(grid, p, direction.y);
+        }
+        return jumpDiagonal(grid, p, direction);
+    }
+
+    // The directions an optimal path can continue in from p when it arrived
+    // from direction.
+    template<typename Grid>
+    std::size_t successorDirections(const Grid& grid, Point p,
+            Point direction, std::array<Point, 8>& result) const {
+        std::size_t count = 0;
+        if (direction == p00) {
+            for (Point offset : Neighborhood{}.offsets(p)) {
+                result[count++] = offset;
+            }
+            return count;
+        }
+        result[count++] = direction;
+        if (direction.x != 0 && direction.y != 0) {
+            result[count++] = Point{direction.x, 0};
+            result[count++] = Point{0, direction.y};
+        } else if (direction.y == 0) {
+            for (int side : {-1, 1}) {
+                if (grid.passable(p.x, p.y + side) &&
+                        !grid.passable(p.x - direction.x, p.y + side)) {
+                    result[count++] = Point{0, side};
+                    if (diagonal) {
+                        result[count++] = Point{direction.x, side};
+                    }
+                }
+            }
+        } else if (diagonal) {
+            for (int side : {-1, 1}) {
+                if (grid.passable(p.x + side, p.y) &&
+                        !grid.passable(p.x + side, p.y - direction.y)) {
+                    result[count++] = Point{side, 0};
+                    result[count++] = Point{side, direction.y};
+                }
+            }
+        } else {
+            result[count++] = Point{-1, 0};
+            result[count++] = Point{1, 0};
+        }
+        return count;
+    }
+
+    void prepare(std::size_t width, std::size_t height) {
+        if (state_.width() != width || state_.height() != height) {
+            reached_.reset(width, height);
+            state_.reset(width, height, 0);
+            parents_.reset(width, height);
+            generation_ = 0;
+        }
+        generation_ += 2;
+        if (generation_ >= std::numeric_limits<std::uint32_t>::max() - 1) {
+            state_.fill(0);
+            generation_ = 2;
+        }
+    }
+
+    template<typename Grid>
+    bool search(const Grid& grid) {
+        std::uint32_t open = generation_;
+        std::uint32_t closed = generation_ + 1;
+        queue_.clear();
+        reached_[start_] = 0;
+        parents_[start_] = start_;
+        state_[start_] = open;
+        queue_.push(distance(start_, goal_), index(start_));
+        std::array<Point, 8> directions;
+        while (!queue_.empty()) {
+            Point p = point(queue_.pop().second);
+            if (state_[p] != open) {
+                continue;
+            }
+            state_[p] = closed;
+            if (p == goal_) {
+                return true;
+            }
+            ++expandedCount_;
+            Point parent = parents_[p];
+            Point direction{detail::sign(p.x - parent.x),
+                    detail::sign(p.y - parent.y)};
+            std::size_t count = successorDirections(grid, p, direction,
+                    directions);
+            for (std::size_t i = 0; i < count; ++i) {
+                auto jumpPoint = jump(grid, p, directions[i]);
+                if (!jumpPoint) {
+                    continue;
+                }
+                Point q = *jumpPoint;
+                int cost = reached_[p] + distance(p, q);
+                std::uint32_t& state = state_[q];
+                if (state == closed || (state == open && reached_[q] <= cost)) {
+                    continue;
+                }
+                state = open;
+                reached_[q] = cost;
+                parents_[q] = p;
+                queue_.push(cost + distance(q, goal_), index(q));
+            }
+        }
+        return false;
+    }
+
+public:
+    // Returns the cost of the shortest path, or none if goal cannot be
+    // reached. passability is a matrix of bools, or a BitMatrix.
+    template<typename Passability>
+    boost::optional<int> findPath(const Passability& passability,
+            Point start, Point goal) {
+        assert(isInsideMatrix(passability, start));
+        assert(isInsideMatrix(passability, goal));
+        prepare(passability.width(), passability.height());
+        start_ = start;
+        goal_ = goal;
+        expandedCount_ = 0;
+        detail::JumpGrid<Passability> grid{passability};
+        found_ = grid.passable(start.x, start.y) &&
+                grid.passable(goal.x, goal.y) && search(grid);
+        if (!found_) {
+            return boost::none;
+        }
+        return reached_[goal];
+    }
+
+    // The jump points of the path found by the last search, from start to
+    // goal. Empty if there was no path.
+    std::vector<Point> jumpPoints() const {
+        std::vector<Point> result;
+        if (!found_) {
+            return result;
+        }
+        for (Point p = goal_; ; p = parents_[p]) {
+            result.push_back(p);
+            if (p == start_) {
+                break;
+            }
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    // Every cell of the path found by the last search, from start to goal.
+    std::vector<Point> path() const {
+        std::vector<Point> points = jumpPoints();
+        std::vector<Point> result;
+        if (points.empty()) {
+            return result;
+        }
+        result.push_back(points.front());
+        for (std::size_t i = 1; i < points.size(); ++i) {
+            Point direction{detail::sign(points[i].x - points[i - 1].x),
+                    detail::sign(points[i].y - points[i - 1].y)};
+            for (Point p = points[i - 1]; p != points[i];) {
+                p += direction;
+                result.push_back(p);
+            }
+        }
+        return result;
+    }
+
+    // The number of jump points expanded by the last search.
+    std::size_t expandedCount() const { return expandedCount_; }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_JUMPPOINTSEARCH_HPP
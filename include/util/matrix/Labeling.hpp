@@ -0,0 +1,293 @@
+#ifndef UTIL_MATRIX_LABELING_HPP
+#define UTIL_MATRIX_LABELING_HPP
+
+#include "Matrix.hpp"
+#include "Neighborhoods.hpp"
+#include "ParallelAlgorithms.hpp"
+#include "PointRange.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// Connected component labeling. Two neighboring cells (see
+// Neighborhoods.hpp) belong to the same component if
+// equivalent(value1, value2) is true, which must be an equivalence relation.
+// The neighborhood must be symmetric and contain the horizontal neighbors,
+// which all the predefined ones do.
+//
+// Each row is split into runs of equivalent cells, and the runs are joined
+// with union-find to the runs of the row above them that they touch, so no
+// recursion or explicit stack is needed.
+
+namespace util {
+namespace matrix {
+
+struct Component {
+    std::size_t size;
+    // The smallest rectangle containing every cell of the component.
+    PointRange boundingBox;
+};
+
+struct Labeling {
+    // The index of the component in components for every cell.
+    Matrix<std::uint32_t> labels;
+    // In the order of their first cell in row-major order.
+    std::vector<Component> components;
+};
+
+namespace detail {
+
+struct LabelRun {
+    std::uint32_t y, begin, end;
+};
+
+inline std::uint32_t findLabelRoot(std::vector<std::uint32_t>& parents,
+        std::uint32_t run) {
+    while (parents[run] != run) {
+        parents[run] = parents[parents[run]];
+        run = parents[run];
+    }
+    return run;
+}
+
+// The run with the smaller index becomes the root, so the root of a component
+// is always its first run.
+inline void uniteLabels(std::vector<std::uint32_t>& parents,
+        std::uint32_t run1, std::uint32_t run2) {
+    run1 = findLabelRoot(parents, run1);
+    run2 = findLabelRoot(parents, run2);
+    if (run1 < run2) {
+        parents[run2] = run1;
+    } else if (run2 < run1) {
+        parents[run1] = run2;
+    }
+}
+
+template<typename Source, typename Neighborhood, typename Equivalent>
+class ComponentLabeler {
+    const Source& source_;
+    const Equivalent& equivalent_;
+    Matrix<std::uint32_t>& labels_;
+    // The horizontal offsets of the neighbors in the row above, for each
+    // x % period.
+    std::array<std::vector<int>, Neighborhood::period> upOffsets_;
+
+    // Joins the runs [runBegin, runEnd) of row y with the runs of the row
+    // above. Run indices are offset by currentOffset and the labels of the row
+    // above by aboveOffset.
+    void connectRow(const std::vector<LabelRun>& runs, std::size_t runBegin,
+            std::size_t runEnd, std::uint32_t currentOffset,
+            std::uint32_t aboveOffset, std::vector<std::uint32_t>& parents) {
+        if (runBegin == runEnd || runs[runBegin].y == 0) {
+            return;
+        }
+        std::size_t y = runs[runBegin].y;
+        int width = source_.width();
+        const auto* row = source_.data() + y * source_.stride();
+        const auto* above = source_.data() + (y - 1) * source_.stride();
+        const std::uint32_t* aboveLabels =
+                labels_.data() + (y - 1) * labels_.stride();
+        for (std::size_t run = runBegin; run < runEnd; ++run) {
+            std::uint32_t id = run + currentOffset;
+            std::uint32_t lastChecked =
+                    std::numeric_limits<std::uint32_t>::max();
+            for (int x = runs[run].begin; x < static_cast<int>(runs[run].end);
+                    ++x) {
+                for (int dx : upOffsets_[x % Neighborhood::period]) {
+                    int nx = x + dx;
+                    if (nx < 0 || nx >= width) {
+                        continue;
+                    }
+                    std::uint32_t other = aboveLabels[nx] + aboveOffset;
+                    if (other == lastChecked) {
+                        continue;
+                    }
+                    lastChecked = other;
+                    if (equivalent_(row[x], above[nx])) {
+                        uniteLabels(parents, id, other);
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    ComponentLabeler(const Source& source, const Neighborhood& neighborhood,
+            const Equivalent& equivalent, Matrix<std::uint32_t>& labels):
+        source_(source), equivalent_(equivalent), labels_(labels)
+    {
+        for (int variant = 0; variant < Neighborhood::period; ++variant) {
+            bool hasLeft = false, hasRight = false;
+            for (Point offset : neighborhood.offsets(Point{variant, 0})) {
+                assert(offset.x >= -1 && offset.x <= 1 &&
+                        offset.y >= -1 && offset.y <= 1);
+                if (offset.y == -1) {
+                    upOffsets_[variant].push_back(offset.x);
+                } else if (offset.y == 0) {
+                    (offset.x < 0 ? hasLeft : hasRight) = true;
+                }
+            }
+            assert(hasLeft && hasRight);
+            (void)hasLeft;
+            (void)hasRight;
+        }
+    }
+
+    // Finds the runs of rows [yBegin, yEnd) and joins the ones inside the
+    // band. Runs are numbered from 0 in the band, both in runs and in the
+    // labels.
+    void labelBand(std::size_t yBegin, std::size_t yEnd,
+            std::vector<LabelRun>& runs, std::vector<std::uint32_t>& parents) {
+        std::size_t width = source_.width();
+        for (std::size_t y = yBegin; y < yEnd; ++y) {
+            const auto* row = source_.data() + y * source_.stride();
+            std::uint32_t* rowLabels = labels_.data() + y * labels_.stride();
+            std::size_t rowBegin = runs.size();
+            std::size_t begin = 0;
+            while (begin < width) {
+                std::size_t end = begin + 1;
+                while (end < width && equivalent_(row[end - 1], row[end])) {
+                    ++end;
+                }
+                std::uint32_t id = runs.size();
+                runs.push_back(LabelRun{static_cast<std::uint32_t>(y),
+                        static_cast<std::uint32_t>(begin),
+                        static_cast<std::uint32_t>(end)});
+                parents.push_back(id);
+                std::fill(rowLabels + begin, rowLabels + end, id);
+                begin = end;
+            }
+            if (y != yBegin) {
+                connectRow(runs, rowBegin, runs.size(), 0, 0, parents);
+            }
+        }
+    }
+
+    // Joins the first row of a band with the last row of the band above.
+    void connectBands(const std::vector<LabelRun>& runs,
+            std::uint32_t currentOffset, std::uint32_t aboveOffset,
+            std::vector<std::uint32_t>& parents) {
+        std::size_t end = 0;
+        while (end < runs.size() && runs[end].y == runs[0].y) {
+            ++end;
+        }
+        connectRow(runs, 0, end, currentOffset, aboveOffset, parents);
+    }
+};
+
+template<typename Source, typename Neighborhood, typename Equivalent,
+        typename ForBands>
+Labeling labelComponents(const Source& source,
+        const Neighborhood& neighborhood, const Equivalent& equivalent,
+        std::size_t grain, ForBands forBands) {
+    Labeling result;
+    std::size_t height = source.height();
+    result.labels.reset(source.width(), height);
+    if (source.width() == 0 || height == 0) {
+        return result;
+    }
+    ComponentLabeler<Source, Neighborhood, Equivalent> labeler{
+            source, neighborhood, equivalent, result.labels};
+
+    std::size_t numBands = (height + grain - 1) / grain;
+    std::vector<std::vector<LabelRun>> runs(numBands);
+    std::vector<std::vector<std::uint32_t>> localParents(numBands);
+    forBands([&](std::size_t begin, std::size_t end) {
+            std::size_t band = begin / grain;
+            labeler.labelBand(begin, end, runs[band], localParents[band]);
+        });
+
+    std::vector<std::uint32_t> offsets(numBands + 1, 0);
+    for (std::size_t band = 0; band < numBands; ++band) {
+        offsets[band + 1] = offsets[band] + runs[band].size();
+    }
+    std::vector<std::uint32_t> parents;
+    parents.reserve(offsets.back());
+    for (std::size_t band = 0; band < numBands; ++band) {
+        for (std::uint32_t parent : localParents[band]) {
+            parents.push_back(parent + offsets[band]);
+        }
+        localParents[band] = std::vector<std::uint32_t>{};
+    }
+    for (std::size_t band = 1; band < numBands; ++band) {
+        labeler.connectBands(runs[band], offsets[band], offsets[band - 1],
+                parents);
+    }
+
+    const std::uint32_t unassigned = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> componentOfRun(offsets.back(), unassigned);
+    for (std::size_t band = 0; band < numBands; ++band) {
+        for (std::size_t i = 0; i < runs[band].size(); ++i) {
+            const LabelRun& run = runs[band][i];
+            std::uint32_t id = i + offsets[band];
+            std::uint32_t root = findLabelRoot(parents, id);
+            Point begin(run.begin, run.y);
+            Point end(run.end, run.y + 1);
+            if (componentOfRun[root] == unassigned) {
+                componentOfRun[root] = result.components.size();
+                result.components.push_back(
+                        Component{0, PointRange{begin, end}});
+            }
+            std::uint32_t component = componentOfRun[root];
+            componentOfRun[id] = component;
+            Component& data = result.components[component];
+            data.size += run.end - run.begin;
+            Point boxBegin = data.boundingBox.beginPoint();
+            Point boxEnd = data.boundingBox.endPoint();
+            data.boundingBox = PointRange{
+                    Point{std::min(boxBegin.x, begin.x), boxBegin.y},
+                    Point{std::max(boxEnd.x, end.x), end.y}};
+        }
+    }
+
+    forBands([&](std::size_t begin, std::size_t /*end*/) {
+            std::size_t band = begin / grain;
+            for (std::size_t i = 0; i < runs[band].size(); ++i) {
+                const LabelRun& run = runs[band][i];
+                std::uint32_t* row =
+                        result.labels.data() + run.y * result.labels.stride();
+                std::fill(row + run.begin, row + run.end,
+                        componentOfRun[i + offsets[band]]);
+            }
+        });
+    return result;
+}
+
+} // namespace detail
+
+template<typename Source, typename Neighborhood,
+        typename Equivalent = std::equal_to<>>
+Labeling labelComponents(const Source& source,
+        const Neighborhood& neighborhood, Equivalent equivalent = {}) {
+    std::size_t height = std::max<std::size_t>(source.height(), 1);
+    return detail::labelComponents(source, neighborhood, equivalent, height,
+            [height](auto function) { function(0, height); });
+}
+
+// Labels bands of grain rows on the thread pool, then joins the bands on the
+// calling thread. The result is the same as that of the sequential version.
+template<typename Source, typename Neighborhood,
+        typename Equivalent = std::equal_to<>>
+Labeling labelComponents(ThreadPool& threadPool, const Source& source,
+        const Neighborhood& neighborhood, Equivalent equivalent = {},
+        std::size_t grain = 0) {
+    std::size_t height = source.height();
+    if (grain == 0) {
+        std::size_t bands =
+                std::max<std::size_t>(threadPool.getNumThreads(), 1) * 4;
+        grain = std::max<std::size_t>((height + bands - 1) / bands, 1);
+    }
+    return detail::labelComponents(source, neighborhood, equivalent, grain,
+            [&threadPool, height, grain](auto function) {
+                parallelForBands(threadPool, height, grain, function);
+            });
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_LABELING_HPP
@@ -0,0 +1,213 @@
+#ifndef UTIL_MATRIX_LAYOUTMATRIX_HPP
+#define UTIL_MATRIX_LAYOUTMATRIX_HPP
+
+#include "Matrix.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+namespace matrix {
+
+// A layout maps the cells of a width x height matrix into storage. It
+// provides size(), the number of storage elements needed (possibly more
+// than width * height), and index(p), the storage position of a point.
+
+class RowMajorLayout {
+    std::size_t width_, height_;
+public:
+    RowMajorLayout(std::size_t width, std::size_t height):
+        width_(width), height_(height) {}
+
+    std::size_t size() const { return width_ * height_; }
+    std::size_t index(Point p) const { return p.y * width_ + p.x; }
+};
+
+// Square tiles of tileSize x tileSize cells, stored one after the other in
+// row-major order. Cells within a tile are row-major too.
+template<std::size_t tileSize>
+class TiledLayout {
+    static_assert(tileSize != 0 && (tileSize & (tileSize - 1)) == 0,
+            "Tile size must be a power of two.");
+
+    static constexpr std::size_t log2(std::size_t n) {
+        return n == 1 ? 0 : 1 + log2(n / 2);
+    }
+
+    static constexpr std::size_t shift = log2(tileSize);
+    static constexpr std::size_t mask = tileSize - 1;
+
+    std::size_t tilesPerRow_, tilesPerColumn_;
+public:
+    TiledLayout(std::size_t width, std::size_t height):
+        tilesPerRow_((width + mask) >> shift),
+        tilesPerColumn_((height + mask) >> shift) {}
+
+    std::size_t size() const {
+        return (tilesPerRow_ * tilesPerColumn_) << (2 * shift);
+    }
+
+    std::size_t index(Point p) const {
+        std::size_t x = p.x;
+        std::size_t y = p.y;
+        return (((y >> shift) * tilesPerRow_ + (x >> shift)) << (2 * shift))
+                | ((y & mask) << shift) | (x & mask);
+    }
+};
+
+// Z-order curve. The dimensions are rounded up to powers of two; the
+// low bits of x and y are interleaved and the remaining high bits of the
+// longer dimension select a square block. Best suited for matrices with
+// power of two sizes, others waste up to 3/4 of the storage.
+class MortonLayout {
+    unsigned squareBits_;
+    std::size_t squareMask_;
+    std::size_t size_;
+
+    static unsigned ceilLog2(std::size_t n) {
+        unsigned result = 0;
+        while ((static_cast<std::size_t>(1) << result) < n) {
+            ++result;
+        }
+        return result;
+    }
+
+    static std::uint64_t spreadBits(std::uint64_t v) {
+        v &= 0xFFFFFFFFu;
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFu;
+        v = (v | (v << 8)) & 0x00FF00FF00FF00FFu;
+        v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x3333333333333333u;
+        v = (v | (v << 1)) & 0x5555555555555555u;
+        return v;
+    }
+public:
+    MortonLayout(std::size_t width, std::size_t height) {
+        unsigned widthBits = ceilLog2(width);
+        unsigned heightBits = ceilLog2(height);
+        squareBits_ = std::min(widthBits, heightBits);
+        squareMask_ = (static_cast<std::size_t>(1) << squareBits_) - 1;
+        size_ = width == 0 || height == 0 ?
+                0 : static_cast<std::size_t>(1) << (widthBits + heightBits);
+    }
+
+    std::size_t size() const { return size_; }
+
+    std::size_t index(Point p) const {
+        std::size_t x = p.x;
+        std::size_t y = p.y;
+        std::size_t block = (x >> squareBits_) | (y >> squareBits_);
+        return (block << (2 * squareBits_)) | spreadBits(x & squareMask_) |
+                (spreadBits(y & squareMask_) << 1);
+    }
+};
+
+// Point-indexed matrix with a configurable storage layout. Unlike Matrix it
+// has no element iterators, because the storage order is not row-major and
+// may contain unused cells; iterate with matrixRange() instead.
+template<typename T, typename Layout>
+class LayoutMatrix {
+    typedef std::vector<T> Data;
+    std::size_t width_, height_;
+    Layout layout_;
+    Data data_;
+public:
+    typedef T valueType;
+    typedef typename Data::reference reference;
+    typedef typename Data::const_reference const_reference;
+
+    LayoutMatrix(): width_(0), height_(0), layout_(0, 0) {}
+
+    LayoutMatrix(std::size_t width, std::size_t height,
+            const T& defValue = T()):
+        width_(width), height_(height), layout_(width, height),
+        data_(layout_.size(), defValue)
+    {}
+
+    template<typename U, typename OtherAllocator>
+    explicit LayoutMatrix(const Matrix<U, OtherAllocator>& other):
+        LayoutMatrix(other.width(), other.height())
+    {
+        static_assert(std::is_convertible<U, T>::value,
+                "Cannot convert between matrices of incompatible types.");
+        for (Point p : matrixRange(other)) {
+            (*this)[p] = other[p];
+        }
+    }
+
+    reference operator[](Point p) {
+        assert(isInsideMatrix(*this, p));
+        return data_[layout_.index(p)];
+    }
+    const_reference operator[](Point p) const {
+        assert(isInsideMatrix(*this, p));
+        return data_[layout_.index(p)];
+    }
+
+    std::size_t size() const { return width_ * height_; }
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    const Layout& layout() const { return layout_; }
+
+    void reset(std::size_t newWidth, std::size_t newHeight,
+            const T& defValue = T())
+    {
+        width_ = newWidth;
+        height_ = newHeight;
+        layout_ = Layout{width_, height_};
+        data_.resize(layout_.size());
+        fill(defValue);
+    }
+    void fill(const T& value)
+    {
+        std::fill(data_.begin(), data_.end(), value);
+    }
+    void clear()
+    {
+        data_.clear();
+        width_ = 0;
+        height_ = 0;
+        layout_ = Layout{0, 0};
+    }
+
+    Matrix<T> toMatrix() const {
+        Matrix<T> result{width_, height_};
+        for (Point p : matrixRange(result)) {
+            result[p] = (*this)[p];
+        }
+        return result;
+    }
+
+    bool operator==(const LayoutMatrix& other) const
+    {
+        if (width_ != other.width_ || height_ != other.height_) {
+            return false;
+        }
+        for (Point p : matrixRange(*this)) {
+            if (!((*this)[p] == other[p])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template<typename T, typename Layout>
+inline bool operator!=(const LayoutMatrix<T, Layout>& lhs,
+        const LayoutMatrix<T, Layout>& rhs) {
+    return !(lhs == rhs);
+}
+
+template<typename T, std::size_t tileSize = 8>
+using TiledMatrix = LayoutMatrix<T, TiledLayout<tileSize>>;
+
+template<typename T>
+using MortonMatrix = LayoutMatrix<T, MortonLayout>;
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_LAYOUTMATRIX_HPP
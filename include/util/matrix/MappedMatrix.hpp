@@ -0,0 +1,158 @@
+#ifndef UTIL_MATRIX_MAPPEDMATRIX_HPP
+#define UTIL_MATRIX_MAPPEDMATRIX_HPP
+
+#include "Matrix.hpp"
+#include "MatrixFileFormat.hpp"
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace util {
+namespace matrix {
+
+// A matrix stored in a memory mapped file in the format described in
+// MatrixFileFormat.hpp. Opening is constant time, the pages are read on
+// demand and shared between processes mapping the same file. Only files in
+// native byte order can be mapped.
+//
+// With MapMode::readOnly the non-const accessors must not be used for
+// writing.
+template<typename T>
+class MappedMatrix {
+    static_assert(std::is_trivially_copyable<T>::value,
+            "MappedMatrix needs a trivially copyable type.");
+
+    MappedFile file_;
+    std::size_t width_ = 0;
+    std::size_t height_ = 0;
+    T* data_ = nullptr;
+
+    static constexpr std::size_t dataOffset = sizeof(MatrixFileHeader);
+
+    explicit MappedMatrix(MappedFile file): file_(std::move(file)) {
+        if (file_.size() < dataOffset) {
+            BOOST_THROW_EXCEPTION(MatrixFileError{
+                    "Matrix file too short: " + file_.fileName()});
+        }
+        MatrixFileHeader header;
+        std::memcpy(&header, file_.data(), sizeof(header));
+        if (checkMatrixFileHeader(header, sizeof(T))) {
+            BOOST_THROW_EXCEPTION(MatrixFileError{
+                    "Cannot map matrix file with foreign byte order: " +
+                    file_.fileName()});
+        }
+        if ((file_.size() - dataOffset) / sizeof(T) <
+                matrixFileCellCount(header)) {
+            BOOST_THROW_EXCEPTION(MatrixFileError{
+                    "Matrix file too short: " + file_.fileName()});
+        }
+        width_ = header.width;
+        height_ = header.height;
+        data_ = reinterpret_cast<T*>(file_.data() + dataOffset);
+    }
+
+public:
+    typedef T valueType;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    MappedMatrix() = default;
+    MappedMatrix(MappedMatrix&& other) noexcept:
+        file_(std::move(other.file_)),
+        width_(other.width_), height_(other.height_), data_(other.data_)
+    {
+        other.width_ = 0;
+        other.height_ = 0;
+        other.data_ = nullptr;
+    }
+    MappedMatrix& operator=(MappedMatrix&& other) noexcept {
+        file_ = std::move(other.file_);
+        width_ = other.width_;
+        height_ = other.height_;
+        data_ = other.data_;
+        other.width_ = 0;
+        other.height_ = 0;
+        other.data_ = nullptr;
+        return *this;
+    }
+
+    static MappedMatrix open(const std::string& fileName,
+            MapMode mode = MapMode::readOnly, bool populate = false) {
+        return MappedMatrix{MappedFile{fileName, mode, populate}};
+    }
+
+    // Creates or overwrites the file and maps it read-write. Throws
+    // MatrixFileError if the size of the file would overflow.
+    static MappedMatrix create(const std::string& fileName,
+            std::size_t width, std::size_t height,
+            const T& defValue = T()) {
+        MatrixFileHeader header = makeMatrixFileHeader(sizeof(T),
+                width, height);
+        MappedFile file = MappedFile::create(fileName,
+                dataOffset + matrixFileCellCount(header) * sizeof(T));
+        std::memcpy(file.data(), &header, sizeof(header));
+        MappedMatrix result{std::move(file)};
+        result.fill(defValue);
+        return result;
+    }
+
+    template<typename Allocator>
+    static MappedMatrix create(const std::string& fileName,
+            const Matrix<T, Allocator>& matrix) {
+        MappedMatrix result = create(fileName, matrix.width(),
+                matrix.height());
+        std::copy(matrix.begin(), matrix.end(), result.begin());
+        return result;
+    }
+
+    reference operator[](Point p) {
+        assert(isInsideMatrix(*this, p));
+        return data_[p.y*width_ + p.x];
+    }
+    const_reference operator[](Point p) const {
+        assert(isInsideMatrix(*this, p));
+        return data_[p.y*width_ + p.x];
+    }
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    std::size_t size() const { return width_ * height_; }
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    std::size_t stride() const { return width_; }
+    MapMode mode() const { return file_.mode(); }
+    const std::string& fileName() const { return file_.fileName(); }
+
+    void fill(const T& value) {
+        std::fill(begin(), end(), value);
+    }
+
+    void advise(AccessHint hint) {
+        file_.advise(hint, dataOffset, size() * sizeof(T));
+    }
+
+    void flush(bool wait = true) {
+        file_.flush(wait);
+    }
+
+    Matrix<T> toMatrix() const {
+        return Matrix<T>{width_, height_, begin(), end()};
+    }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size(); }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size(); }
+    const_iterator cbegin() const { return data_; }
+    const_iterator cend() const { return data_ + size(); }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_MAPPEDMATRIX_HPP
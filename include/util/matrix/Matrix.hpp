@@ -1,6 +1,8 @@
 #ifndef UTIL_MATRIX_HPP
 #define UTIL_MATRIX_HPP
 
+#include "MatrixCompare.hpp"
+#include "MatrixHash.hpp"
 #include "Point.hpp"
 #include "PointRange.hpp"
 
@@ -11,6 +13,7 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <memory>
 #include <type_traits>
 #include <vector>
 
@@ -23,13 +26,17 @@ inline bool isInsideMatrix(const Matrix& matrix, Point p) {
             p.y < static_cast<int>(matrix.height());
 }
 
-template<typename T>
+// The allocator is used for the element storage. It follows the usual
+// allocator propagation rules of std::vector on copy, move and swap, and
+// reset() keeps the current one.
+template<typename T, typename Allocator = std::allocator<T>>
 class Matrix {
-    typedef std::vector<T> Data;
+    typedef std::vector<T, Allocator> Data;
     std::size_t width_, height_;
     Data data_;
 public:
     typedef T valueType;
+    typedef Allocator allocator_type;
     typedef typename Data::reference reference;
     typedef typename Data::const_reference const_reference;
     typedef typename Data::iterator iterator;
@@ -37,30 +44,51 @@ public:
 
     Matrix(): width_(0), height_(0) {}
 
+    explicit Matrix(const Allocator& allocator):
+        width_(0), height_(0), data_(allocator)
+    {}
+
     Matrix(std::size_t width, std::size_t height,
-            const std::initializer_list<T>& values):
+            const std::initializer_list<T>& values,
+            const Allocator& allocator = Allocator()):
         width_(width), height_(height),
-        data_(values.begin(), values.end())
+        data_(values.begin(), values.end(), allocator)
     {}
 
     template<typename Iterator>
     Matrix(std::size_t width, std::size_t height,
-            Iterator begin, Iterator end):
-        width_(width), height_(height), data_(begin, end)
+            Iterator begin, Iterator end,
+            const Allocator& allocator = Allocator()):
+        width_(width), height_(height), data_(begin, end, allocator)
     {}
 
-    Matrix(std::size_t width, std::size_t height, const T& defValue = T()):
-        width_(width), height_(height), data_(width * height, defValue)
+    Matrix(std::size_t width, std::size_t height, const T& defValue = T(),
+            const Allocator& allocator = Allocator()):
+        width_(width), height_(height),
+        data_(width * height, defValue, allocator)
     {}
     Matrix(const Matrix& ) = default;
+    Matrix(const Matrix& other, const Allocator& allocator):
+        width_(other.width_), height_(other.height_),
+        data_(other.data_, allocator)
+    {}
     Matrix(Matrix&& other) noexcept : width_(other.width_), height_(other.height_),
             data_(std::move(other.data_)) {
         other.width_ = 0;
         other.height_ = 0;
         other.data_.clear();
     }
+    Matrix(Matrix&& other, const Allocator& allocator):
+            width_(other.width_), height_(other.height_),
+            data_(std::move(other.data_), allocator) {
+        other.width_ = 0;
+        other.height_ = 0;
+        other.data_.clear();
+    }
     Matrix& operator=(const Matrix& ) = default;
-    Matrix& operator=(Matrix&& other) noexcept {
+    Matrix& operator=(Matrix&& other) noexcept(
+            std::allocator_traits<Allocator>::
+                    propagate_on_container_move_assignment::value) {
         this->width_ = other.width_;
         this->height_ = other.height_;
         this->data_ = std::move(other.data_);
@@ -70,16 +98,17 @@ public:
         return *this;
     }
 
-    template<typename U>
-    Matrix(const Matrix<U>& other) :
+    template<typename U, typename OtherAllocator>
+    Matrix(const Matrix<U, OtherAllocator>& other,
+            const Allocator& allocator = Allocator()) :
             width_(other.width()), height_(other.height()),
-            data_(other.begin(), other.end()) {
+            data_(other.begin(), other.end(), allocator) {
         static_assert(std::is_convertible<U, T>::value,
                 "Cannot convert between matrices of incompatible types.");
     }
 
-    template<typename U>
-    Matrix& operator=(const Matrix<U>& other) {
+    template<typename U, typename OtherAllocator>
+    Matrix& operator=(const Matrix<U, OtherAllocator>& other) {
         static_assert(std::is_convertible<U, T>::value,
                 "Cannot convert between matrices of incompatible types.");
         width_ = other.width();
@@ -89,6 +118,8 @@ public:
         return *this;
     }
 
+    allocator_type get_allocator() const { return data_.get_allocator(); }
+
     reference operator[](std::size_t pos) {
         return data_[pos];
     }
@@ -104,9 +135,12 @@ public:
         assert(isInsideMatrix(*this, p));
         return data_[p.y*width_ + p.x];
     }
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
     std::size_t size() const { return data_.size(); }
     std::size_t width() const { return width_; }
     std::size_t height() const { return height_; }
+    std::size_t stride() const { return width_; }
     void reset(std::size_t newWidth, std::size_t newHeight,
             const T& defValue = T())
     {
@@ -126,15 +160,16 @@ public:
         height_ = 0;
     }
 
-    bool operator==(const Matrix<T>& other) const
+    template<typename OtherAllocator>
+    bool operator==(const Matrix<T, OtherAllocator>& other) const
     {
-        return width_ == other.width_ && height_ == other.height_
-                && data_ == other.data_;
+        return width_ == other.width() && height_ == other.height()
+                && detail::equalCells(*this, other);
     }
 
-    friend bool operator<(const Matrix<T>& lhs, const Matrix<T>& rhs) {
-        return std::lexicographical_compare(lhs.data_.begin(), lhs.data_.end(),
-                                            rhs.data_.begin(), rhs.data_.end());
+    // Orders by width, height, then the cells, see compare().
+    friend bool operator<(const Matrix& lhs, const Matrix& rhs) {
+        return compare(lhs, rhs) < 0;
     }
 
     iterator begin() { return data_.begin(); }
@@ -152,9 +187,9 @@ public:
     }
 };
 
-template<typename T>
-inline const T matrixAt(const Matrix<T> &arr,
-        Point p, const T& def) {
+template<typename Matrix>
+inline const typename Matrix::valueType matrixAt(const Matrix& arr,
+        Point p, const typename Matrix::valueType& def) {
     return isInsideMatrix(arr, p) ? arr[p] : def;
 }
 
@@ -163,8 +198,9 @@ inline PointRange matrixRange(const Matrix& matrix) {
     return PointRange(Point(0,0), Point(matrix.width(), matrix.height()));
 }
 
-template<typename T>
-inline bool operator!=(const Matrix<T>& lhs, const Matrix<T>& rhs) {
+template<typename T, typename Allocator, typename OtherAllocator>
+inline bool operator!=(const Matrix<T, Allocator>& lhs,
+        const Matrix<T, OtherAllocator>& rhs) {
     return !(lhs == rhs);
 }
 
@@ -172,14 +208,10 @@ inline bool operator!=(const Matrix<T>& lhs, const Matrix<T>& rhs) {
 } // namespace util
 
 namespace std {
-template<typename T>
-struct hash<util::matrix::Matrix<T>> {
-    size_t operator()(const util::matrix::Matrix<T>& arr) const {
-        size_t seed = 0;
-        for (const T& t : arr) {
-            boost::hash_combine(seed, t);
-        }
-        return seed;
+template<typename T, typename Allocator>
+struct hash<util::matrix::Matrix<T, Allocator>> {
+    size_t operator()(const util::matrix::Matrix<T, Allocator>& arr) const {
+        return util::matrix::hashMatrix(arr);
     }
 };
 
@@ -0,0 +1,172 @@
+#ifndef UTIL_MATRIX_MATRIXCOMPARE_HPP
+#define UTIL_MATRIX_MATRIXCOMPARE_HPP
+
+#include "Point.hpp"
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Comparison of matrices that provide width(), height() and operator[],
+// with a memcmp based fast path when both matrices have data() and stride()
+// and their element type is bytewise comparable.
+
+namespace util {
+namespace matrix {
+
+// True if two values are equal exactly when their object representations
+// are equal, so they can be compared with memcmp. Specialize it for other
+// types without padding. Floating point types are excluded because of +0.0
+// and -0.0, and bool because std::vector<bool> has no data().
+template<typename T>
+struct IsBytewiseComparable: std::integral_constant<bool,
+        (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+        std::is_enum<T>::value> {};
+
+template<>
+struct IsBytewiseComparable<Point>: std::true_type {};
+
+namespace detail {
+
+// True if the rows of the matrix can be read through data() and stride().
+template<typename MatrixType, typename = void>
+struct HasRowData: std::false_type {};
+
+template<typename MatrixType>
+struct HasRowData<MatrixType, typename std::enable_if<
+        std::is_pointer<decltype(
+                std::declval<const MatrixType&>().data())>::value &&
+        std::is_integral<decltype(
+                std::declval<const MatrixType&>().stride())>::value>::type>:
+        std::true_type {};
+
+template<typename Matrix1, typename Matrix2>
+using UseBytewiseComparison = std::integral_constant<bool,
+        std::is_same<std::remove_const_t<typename Matrix1::valueType>,
+                std::remove_const_t<typename Matrix2::valueType>>::value &&
+        IsBytewiseComparable<
+                std::remove_const_t<typename Matrix1::valueType>>::value &&
+        HasRowData<Matrix1>::value && HasRowData<Matrix2>::value>;
+
+// The index of the first different element, or size if there is none. The
+// spans are compared in blocks with memcmp first.
+template<typename T>
+std::size_t mismatchSpan(const T* lhs, const T* rhs, std::size_t size) {
+    constexpr std::size_t blockSize = std::max<std::size_t>(256 / sizeof(T),
+            1);
+    for (std::size_t begin = 0; begin < size; begin += blockSize) {
+        std::size_t end = std::min(begin + blockSize, size);
+        if (std::memcmp(lhs + begin, rhs + begin,
+                (end - begin) * sizeof(T)) == 0) {
+            continue;
+        }
+        for (std::size_t i = begin; i < end; ++i) {
+            if (std::memcmp(lhs + i, rhs + i, sizeof(T)) != 0) {
+                return i;
+            }
+        }
+    }
+    return size;
+}
+
+template<typename Matrix1, typename Matrix2>
+boost::optional<Point> firstDifference(const Matrix1& lhs,
+        const Matrix2& rhs, std::true_type) {
+    if (lhs.stride() == lhs.width() && rhs.stride() == rhs.width()) {
+        std::size_t size = lhs.width() * lhs.height();
+        std::size_t index = mismatchSpan(lhs.data(), rhs.data(), size);
+        if (index == size) {
+            return boost::none;
+        }
+        return Point(index % lhs.width(), index / lhs.width());
+    }
+    for (std::size_t y = 0; y < lhs.height(); ++y) {
+        std::size_t x = mismatchSpan(lhs.data() + y * lhs.stride(),
+                rhs.data() + y * rhs.stride(), lhs.width());
+        if (x != lhs.width()) {
+            return Point(x, y);
+        }
+    }
+    return boost::none;
+}
+
+template<typename Matrix1, typename Matrix2>
+boost::optional<Point> firstDifference(const Matrix1& lhs,
+        const Matrix2& rhs, std::false_type) {
+    Point p;
+    for (p.y = 0; p.y < static_cast<int>(lhs.height()); ++p.y) {
+        for (p.x = 0; p.x < static_cast<int>(lhs.width()); ++p.x) {
+            if (!(lhs[p] == rhs[p])) {
+                return p;
+            }
+        }
+    }
+    return boost::none;
+}
+
+template<typename Matrix1, typename Matrix2>
+int compareCells(const Matrix1& lhs, const Matrix2& rhs, std::true_type) {
+    auto p = firstDifference(lhs, rhs, std::true_type{});
+    if (!p) {
+        return 0;
+    }
+    return lhs[*p] < rhs[*p] ? -1 : 1;
+}
+
+template<typename Matrix1, typename Matrix2>
+int compareCells(const Matrix1& lhs, const Matrix2& rhs, std::false_type) {
+    Point p;
+    for (p.y = 0; p.y < static_cast<int>(lhs.height()); ++p.y) {
+        for (p.x = 0; p.x < static_cast<int>(lhs.width()); ++p.x) {
+            if (lhs[p] < rhs[p]) {
+                return -1;
+            }
+            if (rhs[p] < lhs[p]) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+template<typename Matrix1, typename Matrix2>
+bool equalCells(const Matrix1& lhs, const Matrix2& rhs) {
+    return !firstDifference(lhs, rhs,
+            UseBytewiseComparison<Matrix1, Matrix2>{});
+}
+
+} // namespace detail
+
+// The first point in row-major order where the matrices differ, or none if
+// they are equal. The matrices must have the same dimensions.
+template<typename Matrix1, typename Matrix2>
+boost::optional<Point> firstDifference(const Matrix1& lhs,
+        const Matrix2& rhs) {
+    assert(lhs.width() == rhs.width() && lhs.height() == rhs.height());
+    return detail::firstDifference(lhs, rhs,
+            detail::UseBytewiseComparison<Matrix1, Matrix2>{});
+}
+
+// Three-way comparison: negative if lhs is less than rhs, zero if they are
+// equal and positive otherwise. Matrices are ordered by width, then by
+// height, then by their cells in row-major order with operator<.
+template<typename Matrix1, typename Matrix2>
+int compare(const Matrix1& lhs, const Matrix2& rhs) {
+    if (lhs.width() != rhs.width()) {
+        return lhs.width() < rhs.width() ? -1 : 1;
+    }
+    if (lhs.height() != rhs.height()) {
+        return lhs.height() < rhs.height() ? -1 : 1;
+    }
+    return detail::compareCells(lhs, rhs,
+            detail::UseBytewiseComparison<Matrix1, Matrix2>{});
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_MATRIXCOMPARE_HPP
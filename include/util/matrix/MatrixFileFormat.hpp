@@ -0,0 +1,121 @@
+#ifndef UTIL_MATRIX_MATRIXFILEFORMAT_HPP
+#define UTIL_MATRIX_MATRIXFILEFORMAT_HPP
+
+#include <boost/throw_exception.hpp>
+
+#include <assert.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// Binary matrix files: a 64 byte header, followed by the cells in row-major
+// order without padding. The cells are stored in the byte order of the
+// writer, which is recorded in the header.
+
+namespace util {
+namespace matrix {
+
+struct MatrixFileError: std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+constexpr char matrixFileMagic[4] = {'U', 'M', 'T', 'X'};
+constexpr std::uint32_t matrixFileVersion = 1;
+// Written in native byte order, so the reader can tell if it differs.
+constexpr std::uint32_t matrixFileByteOrder = 0x01020304;
+
+struct MatrixFileHeader {
+    char magic[4];
+    std::uint32_t byteOrder;
+    std::uint32_t version;
+    std::uint32_t elementSize;
+    std::uint64_t width;
+    std::uint64_t height;
+    char reserved[32];
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64,
+        "The matrix file header must be 64 bytes.");
+
+inline MatrixFileHeader makeMatrixFileHeader(std::size_t elementSize,
+        std::size_t width, std::size_t height) {
+    MatrixFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, matrixFileMagic, sizeof(header.magic));
+    header.byteOrder = matrixFileByteOrder;
+    header.version = matrixFileVersion;
+    header.elementSize = elementSize;
+    header.width = width;
+    header.height = height;
+    return header;
+}
+
+namespace detail {
+
+inline std::uint32_t byteSwap32(std::uint32_t value) {
+    return __builtin_bswap32(value);
+}
+
+inline std::uint64_t byteSwap64(std::uint64_t value) {
+    return __builtin_bswap64(value);
+}
+
+} // namespace detail
+
+// Validates the header and converts its fields to native byte order. Returns
+// true if the file was written with the opposite byte order. Throws
+// MatrixFileError if the header is invalid or the element size differs.
+inline bool checkMatrixFileHeader(MatrixFileHeader& header,
+        std::size_t elementSize) {
+    if (std::memcmp(header.magic, matrixFileMagic, sizeof(header.magic))
+            != 0) {
+        BOOST_THROW_EXCEPTION(MatrixFileError{"Not a matrix file."});
+    }
+    bool swapped = false;
+    if (header.byteOrder != matrixFileByteOrder) {
+        if (detail::byteSwap32(header.byteOrder) != matrixFileByteOrder) {
+            BOOST_THROW_EXCEPTION(MatrixFileError{
+                    "Invalid byte order mark in matrix file."});
+        }
+        swapped = true;
+        header.byteOrder = matrixFileByteOrder;
+        header.version = detail::byteSwap32(header.version);
+        header.elementSize = detail::byteSwap32(header.elementSize);
+        header.width = detail::byteSwap64(header.width);
+        header.height = detail::byteSwap64(header.height);
+    }
+    if (header.version != matrixFileVersion) {
+        BOOST_THROW_EXCEPTION(MatrixFileError{
+                "Unsupported matrix file version: " +
+                std::to_string(header.version)});
+    }
+    if (header.elementSize != elementSize) {
+        BOOST_THROW_EXCEPTION(MatrixFileError{
+                "Element size mismatch in matrix file: expected " +
+                std::to_string(elementSize) + ", got " +
+                std::to_string(header.elementSize)});
+    }
+    return swapped;
+}
+
+// The number of cells of a checked header. Throws MatrixFileError if
+// width * height overflows, or the file with these cells would not fit in
+// memory.
+inline std::size_t matrixFileCellCount(const MatrixFileHeader& header) {
+    assert(header.elementSize != 0);
+    std::uint64_t maxCells = (std::numeric_limits<std::size_t>::max() -
+            sizeof(MatrixFileHeader)) / header.elementSize;
+    if (header.height != 0 && header.width > maxCells / header.height) {
+        BOOST_THROW_EXCEPTION(MatrixFileError{
+                "Matrix file too large: " + std::to_string(header.width) +
+                "x" + std::to_string(header.height)});
+    }
+    return header.width * header.height;
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_MATRIXFILEFORMAT_HPP
@@ -0,0 +1,247 @@
+#ifndef UTIL_MATRIX_MATRIXHASH_HPP
+#define UTIL_MATRIX_MATRIXHASH_HPP
+
+#include "MatrixCompare.hpp"
+#include "Point.hpp"
+
+#include <boost/functional/hash.hpp>
+
+#include <assert.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace util {
+namespace matrix {
+
+// The SplitMix64 finalizer: a cheap bijective mixing function where every
+// input bit affects every output bit.
+inline std::uint64_t splitMix64(std::uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Streaming implementation of the XXH64 hash function. The result only
+// depends on the concatenation of the bytes passed to update(), not on how
+// they are split.
+class Hasher64 {
+    static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+    static constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+    std::uint64_t seed_;
+    std::uint64_t accumulators_[4];
+    unsigned char buffer_[32];
+    std::size_t bufferSize_ = 0;
+    std::uint64_t totalSize_ = 0;
+
+    static std::uint64_t rotateLeft(std::uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    static std::uint64_t read64(const unsigned char* data) {
+        std::uint64_t result;
+        std::memcpy(&result, data, sizeof(result));
+        return result;
+    }
+
+    static std::uint32_t read32(const unsigned char* data) {
+        std::uint32_t result;
+        std::memcpy(&result, data, sizeof(result));
+        return result;
+    }
+
+    static std::uint64_t round(std::uint64_t accumulator,
+            std::uint64_t input) {
+        accumulator += input * prime2;
+        accumulator = rotateLeft(accumulator, 31);
+        return accumulator * prime1;
+    }
+
+    static std::uint64_t mergeRound(std::uint64_t accumulator,
+            std::uint64_t value) {
+        accumulator ^= round(0, value);
+        return accumulator * prime1 + prime4;
+    }
+
+    void processStripe(const unsigned char* data) {
+        accumulators_[0] = round(accumulators_[0], read64(data));
+        accumulators_[1] = round(accumulators_[1], read64(data + 8));
+        accumulators_[2] = round(accumulators_[2], read64(data + 16));
+        accumulators_[3] = round(accumulators_[3], read64(data + 24));
+    }
+
+public:
+    explicit Hasher64(std::uint64_t seed = 0): seed_(seed) {
+        accumulators_[0] = seed + prime1 + prime2;
+        accumulators_[1] = seed + prime2;
+        accumulators_[2] = seed;
+        accumulators_[3] = seed - prime1;
+    }
+
+    void update(const void* data, std::size_t size) {
+        auto input = static_cast<const unsigned char*>(data);
+        totalSize_ += size;
+        if (bufferSize_ + size < sizeof(buffer_)) {
+            std::memcpy(buffer_ + bufferSize_, input, size);
+            bufferSize_ += size;
+            return;
+        }
+        if (bufferSize_ != 0) {
+            std::size_t fill = sizeof(buffer_) - bufferSize_;
+            std::memcpy(buffer_ + bufferSize_, input, fill);
+            processStripe(buffer_);
+            input += fill;
+            size -= fill;
+            bufferSize_ = 0;
+        }
+        for (; size >= sizeof(buffer_); size -= sizeof(buffer_)) {
+            processStripe(input);
+            input += sizeof(buffer_);
+        }
+        std::memcpy(buffer_, input, size);
+        bufferSize_ = size;
+    }
+
+    template<typename T>
+    void updateValue(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable values can be hashed as bytes.");
+        update(&value, sizeof(value));
+    }
+
+    std::uint64_t finish() const {
+        std::uint64_t result;
+        if (totalSize_ >= sizeof(buffer_)) {
+            result = rotateLeft(accumulators_[0], 1) +
+                    rotateLeft(accumulators_[1], 7) +
+                    rotateLeft(accumulators_[2], 12) +
+                    rotateLeft(accumulators_[3], 18);
+            for (std::uint64_t accumulator : accumulators_) {
+                result = mergeRound(result, accumulator);
+            }
+        } else {
+            result = seed_ + prime5;
+        }
+        result += totalSize_;
+
+        const unsigned char* data = buffer_;
+        std::size_t size = bufferSize_;
+        for (; size >= 8; size -= 8, data += 8) {
+            result ^= round(0, read64(data));
+            result = rotateLeft(result, 27) * prime1 + prime4;
+        }
+        if (size >= 4) {
+            result ^= read32(data) * prime1;
+            result = rotateLeft(result, 23) * prime2 + prime3;
+            size -= 4;
+            data += 4;
+        }
+        for (; size > 0; --size, ++data) {
+            result ^= *data * prime5;
+            result = rotateLeft(result, 11) * prime1;
+        }
+
+        result ^= result >> 33;
+        result *= prime2;
+        result ^= result >> 29;
+        result *= prime3;
+        result ^= result >> 32;
+        return result;
+    }
+};
+
+// Types that are hashed as bytes. Specialize it for types that are not
+// bytewise comparable, but whose padding is always zeroed.
+template<typename T>
+struct IsBytewiseHashable: IsBytewiseComparable<T> {};
+
+namespace detail {
+
+// Bytewise hashable cells of matrices with data() and stride(): whole rows.
+template<typename MatrixType>
+void hashRows(Hasher64& hasher, const MatrixType& matrix, Point origin,
+        std::size_t width, std::size_t height, std::true_type,
+        std::true_type) {
+    using T = typename MatrixType::valueType;
+    for (std::size_t y = 0; y < height; ++y) {
+        hasher.update(matrix.data() + (origin.y + y) * matrix.stride() +
+                origin.x, width * sizeof(T));
+    }
+}
+
+// Bytewise hashable cells of other matrices: the same bytes, one cell at a
+// time.
+template<typename MatrixType>
+void hashRows(Hasher64& hasher, const MatrixType& matrix, Point origin,
+        std::size_t width, std::size_t height, std::true_type,
+        std::false_type) {
+    using T = std::remove_const_t<typename MatrixType::valueType>;
+    Point p;
+    for (p.y = origin.y; p.y < origin.y + static_cast<int>(height); ++p.y) {
+        for (p.x = origin.x; p.x < origin.x + static_cast<int>(width);
+                ++p.x) {
+            T value = matrix[p];
+            hasher.update(&value, sizeof(T));
+        }
+    }
+}
+
+template<typename MatrixType, typename HasRowData>
+void hashRows(Hasher64& hasher, const MatrixType& matrix, Point origin,
+        std::size_t width, std::size_t height, std::false_type,
+        HasRowData) {
+    using T = std::remove_const_t<typename MatrixType::valueType>;
+    boost::hash<T> hash;
+    Point p;
+    for (p.y = origin.y; p.y < origin.y + static_cast<int>(height); ++p.y) {
+        for (p.x = origin.x; p.x < origin.x + static_cast<int>(width);
+                ++p.x) {
+            hasher.updateValue(static_cast<std::uint64_t>(hash(matrix[p])));
+        }
+    }
+}
+
+} // namespace detail
+
+// Hashes the width x height rectangle starting at origin, including its
+// dimensions. The result is the same as that of hashMatrix() on a copy of the
+// rectangle. Bytewise hashable types are hashed as raw bytes, row by row if
+// the matrix has data() and stride(), cell by cell otherwise; for other
+// types the boost::hash of each cell is hashed.
+template<typename MatrixType>
+std::uint64_t hashMatrix(const MatrixType& matrix, Point origin,
+        std::size_t width, std::size_t height, std::uint64_t seed = 0) {
+    using T = std::remove_const_t<typename MatrixType::valueType>;
+    assert(width == 0 || height == 0 || (isInsideMatrix(matrix, origin) &&
+            isInsideMatrix(matrix, origin + Point(width - 1, height - 1))));
+    Hasher64 hasher{seed};
+    hasher.updateValue(static_cast<std::uint64_t>(width));
+    hasher.updateValue(static_cast<std::uint64_t>(height));
+    detail::hashRows(hasher, matrix, origin, width, height,
+            IsBytewiseHashable<T>{}, detail::HasRowData<MatrixType>{});
+    return hasher.finish();
+}
+
+template<typename MatrixType>
+std::uint64_t hashMatrix(const MatrixType& matrix, std::uint64_t seed = 0) {
+    return hashMatrix(matrix, Point{0, 0}, matrix.width(), matrix.height(),
+            seed);
+}
+
+// For std::unordered_set and friends.
+struct MatrixHash {
+    template<typename MatrixType>
+    std::size_t operator()(const MatrixType& matrix) const {
+        return hashMatrix(matrix);
+    }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_MATRIXHASH_HPP
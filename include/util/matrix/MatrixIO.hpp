@@ -31,8 +31,9 @@ void readValue(std::istream& s, char& c) {
 
 } // namespace detail
 
-template<typename T>
-std::ostream& operator<<(std::ostream& os, const Matrix<T>& matrix) {
+template<typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& os,
+        const Matrix<T, Allocator>& matrix) {
     dumpMatrix(os, matrix, " ");
     return os;
 }
@@ -76,8 +77,8 @@ Matrix<T> loadMatrix(std::istream& is, const T& defaultValue = T{},
     return result;
 }
 
-template<typename T>
-std::istream& operator>>(std::istream& is, Matrix<T>& matrix) {
+template<typename T, typename Allocator>
+std::istream& operator>>(std::istream& is, Matrix<T, Allocator>& matrix) {
     matrix = loadMatrix<T>(is);
     return is;
 }
@@ -0,0 +1,316 @@
+#ifndef UTIL_MATRIX_MATRIXKERNELS_HPP
+#define UTIL_MATRIX_MATRIXKERNELS_HPP
+
+#include "BitMatrix.hpp"
+#include "Point.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+// Bulk operations over matrices with contiguous rows: Matrix, AlignedMatrix
+// and MatrixView, or anything else that provides data(), stride(), width()
+// and height(). The loops run over raw row pointers instead of Points. For
+// std::int32_t and float the reductions, comparisons and clamp() use SSE2 or
+// AVX2, selected at runtime; other arithmetic types use plain loops that the
+// compiler is free to vectorize. Results for floating point NaN values are
+// unspecified.
+
+namespace util {
+namespace matrix {
+namespace kernels {
+
+enum class SimdLevel { scalar, sse2, avx2 };
+
+// The best level the processor supports.
+SimdLevel getSupportedSimdLevel();
+SimdLevel getSimdLevel();
+// Mainly for testing and benchmarking. Levels above the supported one are
+// lowered to it.
+void setSimdLevel(SimdLevel level);
+
+enum class Comparison {
+    less, lessEqual, equal, notEqual, greaterEqual, greater
+};
+
+namespace detail {
+
+typedef BitMatrix::Word Word;
+
+template<typename T>
+using SumType = std::conditional_t<std::is_floating_point<T>::value, double,
+        std::conditional_t<std::is_signed<T>::value,
+                std::int64_t, std::uint64_t>>;
+
+template<typename T, typename Function>
+auto withComparison(Comparison comparison, T value, Function function) {
+    switch (comparison) {
+    case Comparison::less:
+        return function([value](T t) { return t < value; });
+    case Comparison::lessEqual:
+        return function([value](T t) { return t <= value; });
+    case Comparison::equal:
+        return function([value](T t) { return t == value; });
+    case Comparison::notEqual:
+        return function([value](T t) { return t != value; });
+    case Comparison::greaterEqual:
+        return function([value](T t) { return t >= value; });
+    default:
+        return function([value](T t) { return t > value; });
+    }
+}
+
+// Specializations defined in MatrixKernels.cpp.
+std::int64_t sumSpan(const std::int32_t* data, std::size_t size);
+double sumSpan(const float* data, std::size_t size);
+void minMaxSpan(const std::int32_t* data, std::size_t size,
+        std::int32_t& min, std::int32_t& max);
+void minMaxSpan(const float* data, std::size_t size, float& min, float& max);
+std::size_t countSpan(const std::int32_t* data, std::size_t size,
+        Comparison comparison, std::int32_t value);
+std::size_t countSpan(const float* data, std::size_t size,
+        Comparison comparison, float value);
+void maskSpan(const std::int32_t* data, std::size_t size,
+        Comparison comparison, std::int32_t value, Word* words);
+void maskSpan(const float* data, std::size_t size,
+        Comparison comparison, float value, Word* words);
+void clampSpan(std::int32_t* data, std::size_t size,
+        std::int32_t low, std::int32_t high);
+void clampSpan(float* data, std::size_t size, float low, float high);
+
+template<typename T>
+SumType<T> sumSpan(const T* data, std::size_t size) {
+    SumType<T> result = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        result += data[i];
+    }
+    return result;
+}
+
+// size must not be zero.
+template<typename T>
+void minMaxSpan(const T* data, std::size_t size, T& min, T& max) {
+    min = data[0];
+    max = data[0];
+    for (std::size_t i = 1; i < size; ++i) {
+        min = data[i] < min ? data[i] : min;
+        max = max < data[i] ? data[i] : max;
+    }
+}
+
+template<typename T, typename Predicate>
+std::size_t countIfSpan(const T* data, std::size_t size, Predicate predicate) {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        result += predicate(data[i]) ? 1 : 0;
+    }
+    return result;
+}
+
+template<typename T>
+std::size_t countSpan(const T* data, std::size_t size,
+        Comparison comparison, T value) {
+    return withComparison(comparison, value, [&](auto predicate) {
+                return countIfSpan(data, size, predicate);
+            });
+}
+
+// Sets the bits of words for elements that satisfy the predicate. The words
+// are expected to be zero.
+template<typename T, typename Predicate>
+void maskIfSpan(const T* data, std::size_t size, Predicate predicate,
+        Word* words) {
+    for (std::size_t i = 0; i < size; ++i) {
+        words[i / 64] |= static_cast<Word>(predicate(data[i]) ? 1 : 0)
+                << (i % 64);
+    }
+}
+
+template<typename T>
+void maskSpan(const T* data, std::size_t size, Comparison comparison,
+        T value, Word* words) {
+    withComparison(comparison, value, [&](auto predicate) {
+                maskIfSpan(data, size, predicate, words);
+            });
+}
+
+template<typename T>
+void clampSpan(T* data, std::size_t size, T low, T high) {
+    for (std::size_t i = 0; i < size; ++i) {
+        data[i] = data[i] < low ? low : (high < data[i] ? high : data[i]);
+    }
+}
+
+template<typename MatrixType>
+using ValueType = typename std::decay_t<MatrixType>::valueType;
+
+template<typename MatrixType>
+bool isContiguous(const MatrixType& matrix) {
+    return matrix.stride() == matrix.width() || matrix.height() <= 1;
+}
+
+// Calls function(size, pointers...) for each row of the matrices, or only
+// once for all of the cells if none of the matrices has row padding.
+template<typename Function, typename First, typename... Rest>
+void forEachRow(Function function, First& first, Rest&... rest) {
+    for (bool sameSize : std::initializer_list<bool>{(
+            rest.width() == first.width() &&
+            rest.height() == first.height())...}) {
+        assert(sameSize);
+        (void)sameSize;
+    }
+    bool contiguous = isContiguous(first);
+    for (bool value : std::initializer_list<bool>{isContiguous(rest)...}) {
+        contiguous = contiguous && value;
+    }
+    if (contiguous) {
+        function(first.width() * first.height(), first.data(), rest.data()...);
+        return;
+    }
+    for (std::size_t y = 0; y < first.height(); ++y) {
+        function(first.width(), first.data() + y * first.stride(),
+                (rest.data() + y * rest.stride())...);
+    }
+}
+
+template<typename MatrixType, typename Predicate>
+Point findFirst(const MatrixType& matrix, Predicate predicate) {
+    for (std::size_t y = 0; y < matrix.height(); ++y) {
+        auto row = matrix.data() + y * matrix.stride();
+        for (std::size_t x = 0; x < matrix.width(); ++x) {
+            if (predicate(row[x])) {
+                return Point(static_cast<int>(x), static_cast<int>(y));
+            }
+        }
+    }
+    return Point(-1, -1);
+}
+
+} // namespace detail
+
+// destination[p] = function(source[p]). The source and the destination may
+// be the same matrix.
+template<typename Source, typename Destination, typename Function>
+void transform(const Source& source, Destination&& destination,
+        Function function) {
+    detail::forEachRow([&](std::size_t size, auto in, auto out) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    out[i] = function(in[i]);
+                }
+            }, source, destination);
+}
+
+// destination[p] = function(source1[p], source2[p])
+template<typename Source1, typename Source2, typename Destination,
+        typename Function>
+void zipTransform(const Source1& source1, const Source2& source2,
+        Destination&& destination, Function function) {
+    detail::forEachRow([&](std::size_t size, auto in1, auto in2, auto out) {
+                for (std::size_t i = 0; i < size; ++i) {
+                    out[i] = function(in1[i], in2[i]);
+                }
+            }, source1, source2, destination);
+}
+
+// result[p] == (matrix[p] <comparison> value)
+template<typename MatrixType>
+BitMatrix compareToMask(const MatrixType& matrix, Comparison comparison,
+        detail::ValueType<MatrixType> value) {
+    BitMatrix result{matrix.width(), matrix.height()};
+    for (std::size_t y = 0; y < matrix.height(); ++y) {
+        detail::maskSpan(matrix.data() + y * matrix.stride(), matrix.width(),
+                comparison, value, result.rowWords(y));
+    }
+    return result;
+}
+
+template<typename MatrixType, typename Predicate>
+std::size_t countIf(const MatrixType& matrix, Predicate predicate) {
+    std::size_t result = 0;
+    detail::forEachRow([&](std::size_t size, auto data) {
+                result += detail::countIfSpan(data, size, predicate);
+            }, matrix);
+    return result;
+}
+
+// The number of cells where (matrix[p] <comparison> value).
+template<typename MatrixType>
+std::size_t count(const MatrixType& matrix, Comparison comparison,
+        detail::ValueType<MatrixType> value) {
+    std::size_t result = 0;
+    detail::forEachRow([&](std::size_t size, auto data) {
+                result += detail::countSpan(data, size, comparison, value);
+            }, matrix);
+    return result;
+}
+
+// Integers are summed in 64 bits, floating point values in double.
+template<typename MatrixType>
+detail::SumType<detail::ValueType<MatrixType>> sum(const MatrixType& matrix) {
+    detail::SumType<detail::ValueType<MatrixType>> result = 0;
+    detail::forEachRow([&](std::size_t size, auto data) {
+                result += detail::sumSpan(data, size);
+            }, matrix);
+    return result;
+}
+
+// The matrix must not be empty.
+template<typename MatrixType>
+std::pair<detail::ValueType<MatrixType>, detail::ValueType<MatrixType>>
+minMax(const MatrixType& matrix) {
+    using T = detail::ValueType<MatrixType>;
+    assert(matrix.width() != 0 && matrix.height() != 0);
+    std::pair<T, T> result{matrix.data()[0], matrix.data()[0]};
+    detail::forEachRow([&](std::size_t size, auto data) {
+                T min, max;
+                detail::minMaxSpan(data, size, min, max);
+                result.first = std::min(result.first, min);
+                result.second = std::max(result.second, max);
+            }, matrix);
+    return result;
+}
+
+template<typename MatrixType>
+detail::ValueType<MatrixType> minValue(const MatrixType& matrix) {
+    return minMax(matrix).first;
+}
+
+template<typename MatrixType>
+detail::ValueType<MatrixType> maxValue(const MatrixType& matrix) {
+    return minMax(matrix).second;
+}
+
+// The first position of the minimum in row-major order.
+template<typename MatrixType>
+Point argMin(const MatrixType& matrix) {
+    auto value = minValue(matrix);
+    return detail::findFirst(matrix,
+            [value](const auto& t) { return t == value; });
+}
+
+// The first position of the maximum in row-major order.
+template<typename MatrixType>
+Point argMax(const MatrixType& matrix) {
+    auto value = maxValue(matrix);
+    return detail::findFirst(matrix,
+            [value](const auto& t) { return t == value; });
+}
+
+template<typename MatrixType>
+void clamp(MatrixType&& matrix, detail::ValueType<MatrixType> low,
+        detail::ValueType<MatrixType> high) {
+    assert(!(high < low));
+    detail::forEachRow([&](std::size_t size, auto data) {
+                detail::clampSpan(data, size, low, high);
+            }, matrix);
+}
+
+} // namespace kernels
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_MATRIXKERNELS_HPP
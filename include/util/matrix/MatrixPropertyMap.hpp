@@ -8,41 +8,42 @@
 namespace util {
 namespace matrix {
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>>
 struct MatrixPropertyMap {
-    Matrix<T>& matrix;
+    Matrix<T, Allocator>& matrix;
 };
 
-template<typename T>
-auto matrixPropertyMap(Matrix<T>& matrix) {
-    return MatrixPropertyMap<T>{matrix};
+template<typename T, typename Allocator>
+auto matrixPropertyMap(Matrix<T, Allocator>& matrix) {
+    return MatrixPropertyMap<T, Allocator>{matrix};
 }
 
 namespace boost {
 
-template<typename T>
-struct property_traits<MatrixPropertyMap<T>> {
+template<typename T, typename Allocator>
+struct property_traits<MatrixPropertyMap<T, Allocator>> {
     using category = lvalue_property_map_tag;
     using key_type = Point;
     using value_type = T;
-    using reference = typename Matrix<T>::reference;
+    using reference = typename Matrix<T, Allocator>::reference;
 };
 
 } // namespace boost
 
-template<typename T>
-typename Matrix<T>::reference get(MatrixPropertyMap<T>& map, Point p) {
+template<typename T, typename Allocator>
+typename Matrix<T, Allocator>::reference get(
+        MatrixPropertyMap<T, Allocator>& map, Point p) {
     return map.matrix[p];
 }
 
-template<typename T>
-typename Matrix<T>::const_reference get(const MatrixPropertyMap<T>& map,
-        Point p) {
+template<typename T, typename Allocator>
+typename Matrix<T, Allocator>::const_reference get(
+        const MatrixPropertyMap<T, Allocator>& map, Point p) {
     return map.matrix[p];
 }
 
-template<typename T>
-void put(MatrixPropertyMap<T>& map, Point p, T t) {
+template<typename T, typename Allocator>
+void put(MatrixPropertyMap<T, Allocator>& map, Point p, T t) {
     map.matrix[p] = std::move(t);
 }
 
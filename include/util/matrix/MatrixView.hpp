@@ -0,0 +1,136 @@
+#ifndef UTIL_MATRIX_MATRIXVIEW_HPP
+#define UTIL_MATRIX_MATRIXVIEW_HPP
+
+#include "Matrix.hpp"
+#include "StridedIterator.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <type_traits>
+
+namespace util {
+namespace matrix {
+
+// Non-owning rectangle of another matrix. The source must provide data()
+// and stride(), like Matrix, AlignedMatrix and MatrixView itself do. The
+// view does not keep the source alive and is invalidated by anything that
+// reallocates it.
+template<typename T>
+class MatrixView {
+    T* data_;
+    std::size_t width_, height_, stride_;
+
+    template<typename Source>
+    using EnableForSource = std::enable_if_t<std::is_convertible<
+            decltype(std::declval<Source&>().data()), T*>::value>;
+
+    template<typename Source>
+    using EnableForOtherSource = std::enable_if_t<
+            !std::is_same<std::remove_const_t<Source>, MatrixView>::value,
+            EnableForSource<Source>>;
+public:
+    typedef std::remove_const_t<T> valueType;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef StridedIterator<T> iterator;
+    typedef StridedIterator<const T> const_iterator;
+
+    MatrixView(): data_(nullptr), width_(0), height_(0), stride_(0) {}
+
+    MatrixView(T* data, std::size_t width, std::size_t height,
+            std::size_t stride):
+        data_(data), width_(width), height_(height), stride_(stride)
+    {
+        assert(width_ <= stride_ || height_ <= 1);
+    }
+
+    template<typename Source, typename = EnableForOtherSource<Source>>
+    MatrixView(Source& source):
+        MatrixView(source.data(), source.width(), source.height(),
+                source.stride())
+    {}
+
+    template<typename Source, typename = EnableForSource<Source>>
+    MatrixView(Source& source, Point origin, std::size_t width,
+            std::size_t height):
+        MatrixView(source.data() + origin.y * source.stride() + origin.x,
+                width, height, source.stride())
+    {
+        assert(origin.x >= 0 && origin.y >= 0);
+        assert(origin.x + width <= source.width());
+        assert(origin.y + height <= source.height());
+    }
+
+    template<typename U, typename = std::enable_if_t<
+            std::is_convertible<U*, T*>::value>>
+    MatrixView(const MatrixView<U>& other):
+        MatrixView(other.data(), other.width(), other.height(),
+                other.stride())
+    {}
+
+    reference operator[](Point p) const {
+        assert(isInsideMatrix(*this, p));
+        return data_[p.y*stride_ + p.x];
+    }
+
+    T* row(std::size_t y) const { return data_ + y * stride_; }
+    T* data() const { return data_; }
+
+    std::size_t size() const { return width_ * height_; }
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    std::size_t stride() const { return stride_; }
+
+    MatrixView subView(Point origin, std::size_t width,
+            std::size_t height) const {
+        return MatrixView{*this, origin, width, height};
+    }
+
+    void fill(const valueType& value) const
+    {
+        for (std::size_t y = 0; y < height_; ++y) {
+            std::fill(row(y), row(y) + width_, value);
+        }
+    }
+
+    iterator begin() const {
+        return width_ == 0 ? end() : iterator{data_, width_, stride_};
+    }
+    iterator end() const {
+        return iterator{data_ + stride_ * height_, width_, stride_};
+    }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+};
+
+template<typename T>
+using ConstMatrixView = MatrixView<const T>;
+
+template<typename Source>
+auto matrixView(Source& source) {
+    return MatrixView<std::remove_pointer_t<decltype(source.data())>>{
+            source};
+}
+
+template<typename Source>
+auto matrixView(Source& source, Point origin, std::size_t width,
+        std::size_t height) {
+    return MatrixView<std::remove_pointer_t<decltype(source.data())>>{
+            source, origin, width, height};
+}
+
+template<typename T, typename U>
+bool operator==(const MatrixView<T>& lhs, const MatrixView<U>& rhs) {
+    return lhs.width() == rhs.width() && lhs.height() == rhs.height() &&
+            std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template<typename T, typename U>
+bool operator!=(const MatrixView<T>& lhs, const MatrixView<U>& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_MATRIXVIEW_HPP
@@ -0,0 +1,56 @@
+#ifndef UTIL_MATRIX_NEIGHBORHOODS_HPP
+#define UTIL_MATRIX_NEIGHBORHOODS_HPP
+
+#include "HexMatrix.hpp"
+#include "Point.hpp"
+#include "SquareMatrix.hpp"
+
+#include <array>
+
+// Neighborhoods for algorithms that are generic over the grid type, like
+// stencils and labeling. A neighborhood provides
+//  - size: the number of neighbors,
+//  - period: offsets(p) only depends on p.x % period,
+//  - offsets(p): std::array<Point, size> of the offsets of the neighbors of
+//    p, in a fixed order.
+// Every offset is at most 1 in both directions.
+
+namespace util {
+namespace matrix {
+
+// The 4 edge neighbors, in the order of square::neighbors.
+struct SquareNeighborhood {
+    static constexpr std::size_t size = square::numNeighbors;
+    static constexpr int period = 1;
+
+    const std::array<Point, size>& offsets(Point /*p*/) const {
+        return square::neighbors.data;
+    }
+};
+
+// The 4 edge neighbors followed by the 4 diagonal ones.
+struct SquareDiagonalNeighborhood {
+    static constexpr std::size_t size = 8;
+    static constexpr int period = 1;
+
+    const std::array<Point, size>& offsets(Point /*p*/) const {
+        static constexpr std::array<Point, size> result{{
+                -p10, -p01, p10, p01, -p11, px, p11, -px}};
+        return result;
+    }
+};
+
+// The 6 neighbors on a hex grid, in the order of hex::getNeighbors().
+struct HexNeighborhood {
+    static constexpr std::size_t size = hex::numNeighbors;
+    static constexpr int period = 2;
+
+    const std::array<Point, size>& offsets(Point p) const {
+        return hex::getNeighbors(p).data;
+    }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_NEIGHBORHOODS_HPP
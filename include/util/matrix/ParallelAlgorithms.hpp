@@ -0,0 +1,133 @@
+#ifndef UTIL_MATRIX_PARALLELALGORITHMS_HPP
+#define UTIL_MATRIX_PARALLELALGORITHMS_HPP
+
+#include "MatrixKernels.hpp"
+#include "MatrixView.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace util {
+namespace matrix {
+
+// Splits [0, size) into consecutive bands of grain elements (the last one may
+// be shorter) and calls function(begin, end) for each of them on the threads
+// of the pool, then waits for all of them. If a band throws, the exception of
+// the first failing band is rethrown after every band has finished.
+//
+// A grain of 0 selects about four bands per thread. If the pool is not
+// running, or the call is made from a thread of a pool, the bands are run on
+// the calling thread instead, so waiting cannot deadlock.
+template<typename Function>
+void parallelForBands(ThreadPool& pool, std::size_t size, std::size_t grain,
+        Function function) {
+    if (size == 0) {
+        return;
+    }
+    if (grain == 0) {
+        std::size_t bands = std::max<std::size_t>(pool.getNumThreads(), 1) * 4;
+        grain = std::max<std::size_t>((size + bands - 1) / bands, 1);
+    }
+    if (size <= grain || !pool.isRunning() ||
+            ThreadPool::getCurrentThreadId() != nullptr) {
+        for (std::size_t begin = 0; begin < size; begin += grain) {
+            function(begin, std::min(begin + grain, size));
+        }
+        return;
+    }
+
+    std::vector<std::future<void>> results;
+    results.reserve((size + grain - 1) / grain);
+    for (std::size_t begin = 0; begin < size; begin += grain) {
+        std::size_t end = std::min(begin + grain, size);
+        auto task = std::make_shared<std::packaged_task<void()>>(
+                [&function, begin, end]() { function(begin, end); });
+        results.push_back(task->get_future());
+        pool.getIoService().post([task]() { (*task)(); });
+    }
+    for (auto& result : results) {
+        result.wait();
+    }
+    for (auto& result : results) {
+        result.get();
+    }
+}
+
+// destination[p] = function(source[p]), in bands of grain rows. The matrices
+// must provide data() and stride(), see MatrixKernels.hpp.
+template<typename Source, typename Destination, typename Function>
+void parallelTransform(ThreadPool& pool, const Source& source,
+        Destination&& destination, Function function, std::size_t grain = 0) {
+    assert(source.width() == destination.width() &&
+            source.height() == destination.height());
+    parallelForBands(pool, source.height(), grain,
+            [&](std::size_t begin, std::size_t end) {
+                Point origin{0, static_cast<int>(begin)};
+                kernels::transform(
+                        matrixView(source, origin, source.width(),
+                                end - begin),
+                        matrixView(destination, origin, source.width(),
+                                end - begin),
+                        function);
+            });
+}
+
+// Folds every cell of the matrix. Each band of grain rows starts from
+// identity and folds its cells in row-major order with
+// accumulate(result, value); the band results are then folded in band order
+// with combine(lhs, rhs). The result only depends on the grain, not on the
+// scheduling of the threads.
+template<typename MatrixType, typename T, typename Accumulate,
+        typename Combine>
+T parallelReduce(ThreadPool& pool, const MatrixType& matrix, T identity,
+        Accumulate accumulate, Combine combine, std::size_t grain = 0) {
+    std::size_t height = matrix.height();
+    if (grain == 0) {
+        std::size_t bands = std::max<std::size_t>(pool.getNumThreads(), 1) * 4;
+        grain = std::max<std::size_t>((height + bands - 1) / bands, 1);
+    }
+    std::vector<T> partialResults((height + grain - 1) / grain, identity);
+    parallelForBands(pool, height, grain,
+            [&](std::size_t begin, std::size_t end) {
+                T result = identity;
+                Point p;
+                for (p.y = begin; p.y < static_cast<int>(end); ++p.y) {
+                    for (p.x = 0; p.x < static_cast<int>(matrix.width());
+                            ++p.x) {
+                        result = accumulate(std::move(result), matrix[p]);
+                    }
+                }
+                partialResults[begin / grain] = std::move(result);
+            });
+    T result = std::move(identity);
+    for (T& partialResult : partialResults) {
+        result = combine(std::move(result), std::move(partialResult));
+    }
+    return result;
+}
+
+// Calls function(p) for every point of the matrix, in bands of grain rows.
+// Points of the same band are visited in row-major order.
+template<typename MatrixType, typename Function>
+void parallelForEachPoint(ThreadPool& pool, const MatrixType& matrix,
+        Function function, std::size_t grain = 0) {
+    parallelForBands(pool, matrix.height(), grain,
+            [&](std::size_t begin, std::size_t end) {
+                Point p;
+                for (p.y = begin; p.y < static_cast<int>(end); ++p.y) {
+                    for (p.x = 0; p.x < static_cast<int>(matrix.width());
+                            ++p.x) {
+                        function(p);
+                    }
+                }
+            });
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_PARALLELALGORITHMS_HPP
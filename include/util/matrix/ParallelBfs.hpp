@@ -0,0 +1,361 @@
+#ifndef UTIL_MATRIX_PARALLELBFS_HPP
+#define UTIL_MATRIX_PARALLELBFS_HPP
+
+#include "Matrix.hpp"
+#include "Neighborhoods.hpp"
+#include "ParallelAlgorithms.hpp"
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Breadth-first search from several sources over a large grid, one level at a
+// time, with every level processed in parallel on a ThreadPool.
+//
+// The frontier is kept either as a list of cells (top-down: every frontier
+// cell claims its unvisited neighbors in an atomic visited bitmap) or as a
+// bitmap (bottom-up: every unvisited cell looks for a neighbor in the
+// frontier). Top-down is cheaper for small frontiers, bottom-up for frontiers
+// that touch a large part of the remaining cells; the search switches between
+// them with the heuristics of Beamer, Asanovic and Patterson:
+// "Direction-optimizing breadth-first search".
+
+namespace util {
+namespace matrix {
+
+// The parent direction of sources and unreached cells.
+constexpr std::uint8_t noBfsParent = std::numeric_limits<std::uint8_t>::max();
+
+struct ParallelBfsOptions {
+    // Whether to compute the parent directions.
+    bool parents = false;
+    // Switch to bottom-up when alpha * (the neighbors of the frontier) is more
+    // than the number of unvisited cells. 0 disables bottom-up.
+    std::size_t alpha = 14;
+    // Switch back to top-down when beta * (the size of the frontier) is less
+    // than the number of cells.
+    std::size_t beta = 24;
+};
+
+struct ParallelBfsResult {
+    // The number of steps from the nearest source, or -1 if unreachable.
+    Matrix<int> distances;
+    // The index, in the offsets of the neighborhood at the cell, of the
+    // neighbor the cell was reached from, or noBfsParent. Empty if not
+    // requested. Of several parents at the same distance, any one may be
+    // chosen.
+    Matrix<std::uint8_t> parents;
+};
+
+namespace detail {
+
+template<typename Passability, typename Neighborhood>
+class ParallelBfs {
+    typedef std::uint64_t Word;
+    static constexpr std::size_t wordBits = 64;
+    // Bands smaller than this are not worth a task.
+    static constexpr std::size_t minimumGrain = 1024;
+
+    ThreadPool& threadPool_;
+    const Passability& passability_;
+    Neighborhood neighborhood_;
+    ParallelBfsOptions options_;
+    std::size_t width_, height_, size_, numWords_;
+    ParallelBfsResult result_;
+    // Set for visited and impassable cells.
+    std::vector<std::atomic<Word>> visited_;
+    std::vector<std::uint32_t> frontierList_;
+    std::vector<std::atomic<Word>> frontierBits_;
+    std::vector<std::atomic<Word>> nextBits_;
+    // reverse_[x % period][i] is the index of -offsets(p)[i] in the offsets of
+    // p + offsets(p)[i].
+    std::array<std::array<std::uint8_t, Neighborhood::size>,
+            Neighborhood::period> reverse_;
+
+    Point point(std::size_t index) const {
+        return Point(index % width_, index / width_);
+    }
+    std::uint32_t index(Point p) const { return p.y * width_ + p.x; }
+
+    static Word bit(std::size_t index) {
+        return static_cast<Word>(1) << (index % wordBits);
+    }
+
+    std::size_t grain(std::size_t size) const {
+        std::size_t bands =
+                std::max<std::size_t>(threadPool_.getNumThreads(), 1) * 4;
+        return std::max((size + bands - 1) / bands, minimumGrain);
+    }
+
+    template<typename Function>
+    void forBands(std::size_t size, Function function) {
+        parallelForBands(threadPool_, size, grain(size), function);
+    }
+
+    // Runs function(localResults, begin, end) on bands of [0, size), and
+    // returns the concatenation of the local results in band order.
+    template<typename Function>
+    std::vector<std::uint32_t> collect(std::size_t size, Function function) {
+        std::size_t bandSize = grain(size);
+        std::vector<std::vector<std::uint32_t>> parts(
+                (size + bandSize - 1) / bandSize);
+        parallelForBands(threadPool_, size, bandSize,
+                [&](std::size_t begin, std::size_t end) {
+                    function(parts[begin / bandSize], begin, end);
+                });
+        std::vector<std::uint32_t> result;
+        for (const auto& part : parts) {
+            result.insert(result.end(), part.begin(), part.end());
+        }
+        return result;
+    }
+
+    std::size_t initialize() {
+        result_.distances.reset(width_, height_);
+        if (options_.parents) {
+            result_.parents.reset(width_, height_);
+        }
+        std::vector<std::size_t> unvisited(
+                (numWords_ + grain(numWords_) - 1) / grain(numWords_), 0);
+        forBands(numWords_, [&](std::size_t begin, std::size_t end) {
+                std::size_t count = 0;
+                for (std::size_t word = begin; word < end; ++word) {
+                    Word bits = 0;
+                    std::size_t last = std::min((word + 1) * wordBits, size_);
+                    for (std::size_t i = word * wordBits; i < last; ++i) {
+                        if (passability_[point(i)]) {
+                            ++count;
+                        } else {
+                            bits |= bit(i);
+                        }
+                        result_.distances.data()[i] = -1;
+                        if (options_.parents) {
+                            result_.parents.data()[i] = noBfsParent;
+                        }
+                    }
+                    visited_[word].store(bits, std::memory_order_relaxed);
+                }
+                unvisited[begin / grain(numWords_)] = count;
+            });
+        std::size_t result = 0;
+        for (std::size_t count : unvisited) {
+            result += count;
+        }
+        return result;
+    }
+
+    std::vector<std::uint32_t> topDown(int distance) {
+        return collect(frontierList_.size(),
+                [&](std::vector<std::uint32_t>& next, std::size_t begin,
+                        std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        Point p = point(frontierList_[i]);
+                        const auto& offsets = neighborhood_.offsets(p);
+                        const auto& reverse =
+                                reverse_[p.x % Neighborhood::period];
+                        for (std::size_t j = 0; j < Neighborhood::size; ++j) {
+                            Point q = p + offsets[j];
+                            if (!isInsideMatrix(result_.distances, q)) {
+                                continue;
+                            }
+                            std::uint32_t qi = index(q);
+                            auto& word = visited_[qi / wordBits];
+                            if ((word.load(std::memory_order_relaxed) &
+                                    bit(qi)) != 0 ||
+                                    (word.fetch_or(bit(qi),
+                                            std::memory_order_relaxed) &
+                                    bit(qi)) != 0) {
+                                continue;
+                            }
+                            result_.distances.data()[qi] = distance;
+                            if (options_.parents) {
+                                result_.parents.data()[qi] = reverse[j];
+                            }
+                            next.push_back(qi);
+                        }
+                    }
+                });
+    }
+
+    // Every band owns whole words of the bitmaps, so the words are only
+    // accessed by one thread.
+    std::size_t bottomUp(int distance) {
+        std::vector<std::size_t> counts(
+                (numWords_ + grain(numWords_) - 1) / grain(numWords_), 0);
+        forBands(numWords_, [&](std::size_t begin, std::size_t end) {
+                std::size_t count = 0;
+                for (std::size_t word = begin; word < end; ++word) {
+                    Word visited = visited_[word].load(
+                            std::memory_order_relaxed);
+                    Word candidates = ~visited;
+                    if (word == numWords_ - 1 && size_ % wordBits != 0) {
+                        candidates &= bit(size_) - 1;
+                    }
+                    Word found = 0;
+                    while (candidates != 0) {
+                        std::size_t i = word * wordBits +
+                                __builtin_ctzll(candidates);
+                        candidates &= candidates - 1;
+                        Point p = point(i);
+                        const auto& offsets = neighborhood_.offsets(p);
+                        for (std::size_t j = 0; j < Neighborhood::size; ++j) {
+                            Point q = p + offsets[j];
+                            if (!isInsideMatrix(result_.distances, q)) {
+                                continue;
+                            }
+                            std::uint32_t qi = index(q);
+                            if ((frontierBits_[qi / wordBits].load(
+                                    std::memory_order_relaxed) &
+                                    bit(qi)) == 0) {
+                                continue;
+                            }
+                            found |= bit(i);
+                            result_.distances.data()[i] = distance;
+                            if (options_.parents) {
+                                result_.parents.data()[i] = j;
+                            }
+                            ++count;
+                            break;
+                        }
+                    }
+                    visited_[word].store(visited | found,
+                            std::memory_order_relaxed);
+                    nextBits_[word].store(found, std::memory_order_relaxed);
+                }
+                counts[begin / grain(numWords_)] = count;
+            });
+        frontierBits_.swap(nextBits_);
+        std::size_t result = 0;
+        for (std::size_t count : counts) {
+            result += count;
+        }
+        return result;
+    }
+
+    void listToBits() {
+        forBands(numWords_, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t word = begin; word < end; ++word) {
+                    frontierBits_[word].store(0, std::memory_order_relaxed);
+                }
+            });
+        forBands(frontierList_.size(), [&](std::size_t begin,
+                    std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    std::uint32_t cell = frontierList_[i];
+                    frontierBits_[cell / wordBits].fetch_or(bit(cell),
+                            std::memory_order_relaxed);
+                }
+            });
+        frontierList_.clear();
+    }
+
+    void bitsToList() {
+        frontierList_ = collect(numWords_,
+                [&](std::vector<std::uint32_t>& list, std::size_t begin,
+                        std::size_t end) {
+                    for (std::size_t word = begin; word < end; ++word) {
+                        Word bits = frontierBits_[word].load(
+                                std::memory_order_relaxed);
+                        while (bits != 0) {
+                            list.push_back(word * wordBits +
+                                    __builtin_ctzll(bits));
+                            bits &= bits - 1;
+                        }
+                    }
+                });
+    }
+
+public:
+    ParallelBfs(ThreadPool& threadPool, const Passability& passability,
+            const Neighborhood& neighborhood,
+            const ParallelBfsOptions& options):
+        threadPool_(threadPool), passability_(passability),
+        neighborhood_(neighborhood), options_(options),
+        width_(passability.width()), height_(passability.height()),
+        size_(width_ * height_), numWords_((size_ + wordBits - 1) / wordBits),
+        visited_(numWords_)
+    {
+        assert(size_ <= std::numeric_limits<std::uint32_t>::max());
+        for (int variant = 0; variant < Neighborhood::period; ++variant) {
+            const auto& offsets = neighborhood_.offsets(Point{variant, 0});
+            for (std::size_t i = 0; i < Neighborhood::size; ++i) {
+                const auto& otherOffsets = neighborhood_.offsets(
+                        Point{variant, 0} + offsets[i]);
+                reverse_[variant][i] = std::find(otherOffsets.begin(),
+                        otherOffsets.end(), -offsets[i]) -
+                        otherOffsets.begin();
+            }
+        }
+    }
+
+    ParallelBfsResult run(const std::vector<Point>& sources) {
+        std::size_t unvisited = initialize();
+        for (Point source : sources) {
+            assert(isInsideMatrix(result_.distances, source));
+            std::uint32_t i = index(source);
+            Word old = visited_[i / wordBits].fetch_or(bit(i));
+            if ((old & bit(i)) == 0) {
+                --unvisited;
+            } else if (result_.distances.data()[i] == 0) {
+                continue;
+            }
+            result_.distances.data()[i] = 0;
+            frontierList_.push_back(i);
+        }
+
+        bool isBottomUp = false;
+        std::size_t frontierSize = frontierList_.size();
+        for (int distance = 1; frontierSize != 0; ++distance) {
+            if (!isBottomUp && options_.alpha != 0 && frontierSize *
+                    Neighborhood::size * options_.alpha > unvisited) {
+                if (frontierBits_.empty()) {
+                    frontierBits_ = std::vector<std::atomic<Word>>(numWords_);
+                    nextBits_ = std::vector<std::atomic<Word>>(numWords_);
+                }
+                listToBits();
+                isBottomUp = true;
+            } else if (isBottomUp && frontierSize * options_.beta < size_) {
+                bitsToList();
+                isBottomUp = false;
+            }
+
+            if (isBottomUp) {
+                frontierSize = bottomUp(distance);
+            } else {
+                frontierList_ = topDown(distance);
+                frontierSize = frontierList_.size();
+            }
+            unvisited -= frontierSize;
+        }
+        return std::move(result_);
+    }
+};
+
+template<typename Passability, typename Neighborhood>
+constexpr std::size_t ParallelBfs<Passability, Neighborhood>::wordBits;
+
+template<typename Passability, typename Neighborhood>
+constexpr std::size_t ParallelBfs<Passability, Neighborhood>::minimumGrain;
+
+} // namespace detail
+
+// passability is a matrix of bools (like Matrix<bool> or BitMatrix); only
+// passable cells are entered, but sources are always visited. The neighbors
+// are taken from Neighborhood (see Neighborhoods.hpp).
+template<typename Passability, typename Neighborhood = SquareNeighborhood>
+ParallelBfsResult parallelBfs(ThreadPool& threadPool,
+        const Passability& passability, const std::vector<Point>& sources,
+        const Neighborhood& neighborhood = Neighborhood(),
+        const ParallelBfsOptions& options = ParallelBfsOptions()) {
+    return detail::ParallelBfs<Passability, Neighborhood>{threadPool,
+            passability, neighborhood, options}.run(sources);
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_PARALLELBFS_HPP
@@ -0,0 +1,422 @@
+#ifndef UTIL_MATRIX_PATHFINDING_HPP
+#define UTIL_MATRIX_PATHFINDING_HPP
+
+#include "HexMatrix.hpp"
+#include "Matrix.hpp"
+#include "Neighborhoods.hpp"
+
+#include <boost/optional.hpp>
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Shortest paths over a matrix of cell costs. Stepping into a cell costs the
+// value of the cell, regardless of the direction of the step; cells with a
+// cost of PathFinder::impassable (or more) cannot be entered. Costs must not
+// be negative.
+
+namespace util {
+namespace matrix {
+
+namespace detail {
+
+template<typename Neighborhood>
+struct PathTraits;
+
+template<>
+struct PathTraits<SquareNeighborhood> {
+    static constexpr bool checkCorners = false;
+    static int distance(Point p1, Point p2) {
+        return matrix::distance(p1, p2);
+    }
+};
+
+// Diagonal steps cost the same as straight ones, and may not cut the corner
+// of an impassable cell.
+template<>
+struct PathTraits<SquareDiagonalNeighborhood> {
+    static constexpr bool checkCorners = true;
+    static int distance(Point p1, Point p2) {
+        return chebyshevDistance(p1, p2);
+    }
+};
+
+template<>
+struct PathTraits<HexNeighborhood> {
+    static constexpr bool checkCorners = false;
+    static int distance(Point p1, Point p2) {
+        return hex::distance(p1, p2);
+    }
+};
+
+// Plain binary heap, used for floating point costs.
+template<typename Key>
+class BinaryHeapQueue {
+    typedef std::pair<Key, std::uint32_t> Entry;
+    std::vector<Entry> heap_;
+
+    static bool compare(const Entry& lhs, const Entry& rhs) {
+        return rhs.first < lhs.first;
+    }
+public:
+    void clear() { heap_.clear(); }
+    bool empty() const { return heap_.empty(); }
+
+    void push(Key key, std::uint32_t value) {
+        heap_.emplace_back(key, value);
+        std::push_heap(heap_.begin(), heap_.end(), compare);
+    }
+
+    Entry pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), compare);
+        Entry result = heap_.back();
+        heap_.pop_back();
+        return result;
+    }
+};
+
+// Dial's bucket queue: a circular array of one bucket per key. Keys must not
+// decrease, and every key in the queue must be less than numBuckets above
+// the smallest one.
+class BucketQueue {
+    static constexpr std::uint64_t notStarted =
+            std::numeric_limits<std::uint64_t>::max();
+
+    std::vector<std::vector<std::uint32_t>> buckets_;
+    // The smallest key that can be in the queue, starting from the first key
+    // pushed.
+    std::uint64_t current_ = notStarted;
+    std::size_t size_ = 0;
+public:
+    void reset(std::size_t numBuckets) {
+        for (auto& bucket : buckets_) {
+            bucket.clear();
+        }
+        buckets_.resize(numBuckets);
+        current_ = notStarted;
+        size_ = 0;
+    }
+
+    bool empty() const { return size_ == 0; }
+
+    void push(std::uint64_t key, std::uint32_t value) {
+        if (current_ == notStarted) {
+            current_ = key;
+        }
+        assert(key >= current_ && key - current_ < buckets_.size());
+        buckets_[key % buckets_.size()].push_back(value);
+        ++size_;
+    }
+
+    std::pair<std::uint64_t, std::uint32_t> pop() {
+        assert(size_ != 0);
+        while (buckets_[current_ % buckets_.size()].empty()) {
+            ++current_;
+        }
+        auto& bucket = buckets_[current_ % buckets_.size()];
+        std::uint32_t value = bucket.back();
+        bucket.pop_back();
+        --size_;
+        return {current_, value};
+    }
+};
+
+// Radix heap: entries are kept in buckets by the highest bit in which their
+// key differs from the last popped key. Keys must not decrease.
+class RadixHeap {
+    typedef std::pair<std::uint64_t, std::uint32_t> Entry;
+    std::array<std::vector<Entry>, 65> buckets_;
+    std::uint64_t last_ = 0;
+    std::size_t size_ = 0;
+
+    std::size_t bucketOf(std::uint64_t key) const {
+        return key == last_ ? 0 : 64 - __builtin_clzll(key ^ last_);
+    }
+public:
+    void clear() {
+        for (auto& bucket : buckets_) {
+            bucket.clear();
+        }
+        last_ = 0;
+        size_ = 0;
+    }
+
+    bool empty() const { return size_ == 0; }
+
+    void push(std::uint64_t key, std::uint32_t value) {
+        assert(key >= last_);
+        buckets_[bucketOf(key)].emplace_back(key, value);
+        ++size_;
+    }
+
+    Entry pop() {
+        assert(size_ != 0);
+        if (buckets_[0].empty()) {
+            std::size_t index = 1;
+            while (buckets_[index].empty()) {
+                ++index;
+            }
+            auto& bucket = buckets_[index];
+            last_ = std::min_element(bucket.begin(), bucket.end())->first;
+            for (const Entry& entry : bucket) {
+                buckets_[bucketOf(entry.first)].push_back(entry);
+            }
+            bucket.clear();
+        }
+        Entry result = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        return result;
+    }
+};
+
+} // namespace detail
+
+// A* and Dijkstra search over a cost matrix with any neighborhood from
+// Neighborhoods.hpp. The search state is kept between searches, so a
+// PathFinder should be reused (see threadLocalPathFinder()); it is resized
+// automatically to the cost matrix.
+//
+// Integral costs use a bucket queue if the maximum cell cost is set and at
+// most maxBucketCost, and a radix heap otherwise. Floating point costs use a
+// binary heap.
+template<typename Neighborhood, typename Cost = int>
+class PathFinder {
+public:
+    static constexpr Cost impassable = std::numeric_limits<Cost>::max();
+    static constexpr Cost maxBucketCost = 1024;
+
+private:
+    typedef detail::PathTraits<Neighborhood> Traits;
+
+    Neighborhood neighborhood_;
+    Cost heuristicWeight_ = 1;
+    Cost maxCellCost_ = 0;
+
+    Matrix<Cost> reached_;
+    // A cell is open if its state is generation_, and settled if it is
+    // generation_ + 1.
+    Matrix<std::uint32_t> state_;
+    // The index of the parent in the offsets of the cell.
+    Matrix<std::uint8_t> parents_;
+    std::uint32_t generation_ = 0;
+    Point start_;
+
+    // reverse_[x % period][i] is the index of -offsets(p)[i] in the offsets of
+    // p + offsets(p)[i].
+    std::array<std::array<std::uint8_t, Neighborhood::size>,
+            Neighborhood::period> reverse_;
+
+    detail::BinaryHeapQueue<Cost> heap_;
+    detail::BucketQueue buckets_;
+    detail::RadixHeap radixHeap_;
+
+    static bool isPassable(Cost cost) {
+        assert(!(cost < Cost()));
+        return cost < impassable;
+    }
+
+    std::uint32_t index(Point p) const { return p.y * state_.width() + p.x; }
+    Point point(std::uint32_t index) const {
+        return Point(index % state_.width(), index / state_.width());
+    }
+
+    void prepare(const Matrix<Cost>& costs, Point start) {
+        assert(isInsideMatrix(costs, start));
+        if (state_.width() != costs.width() ||
+                state_.height() != costs.height()) {
+            reached_.reset(costs.width(), costs.height());
+            state_.reset(costs.width(), costs.height(), 0);
+            parents_.reset(costs.width(), costs.height());
+            generation_ = 0;
+        }
+        generation_ += 2;
+        if (generation_ >= std::numeric_limits<std::uint32_t>::max() - 1) {
+            state_.fill(0);
+            generation_ = 2;
+        }
+        start_ = start;
+    }
+
+    template<typename Queue>
+    bool search(Queue& queue, const Matrix<Cost>& costs, const Point* goal) {
+        auto key = [this, goal](Cost cost, Point p) {
+            return goal ? cost + heuristicWeight_ *
+                    static_cast<Cost>(Traits::distance(p, *goal)) : cost;
+        };
+        std::uint32_t open = generation_;
+        std::uint32_t settled = generation_ + 1;
+        reached_[start_] = Cost();
+        state_[start_] = open;
+        queue.push(key(Cost(), start_), index(start_));
+        while (!queue.empty()) {
+            Point p = point(queue.pop().second);
+            if (state_[p] != open) {
+                continue;
+            }
+            state_[p] = settled;
+            if (goal && p == *goal) {
+                return true;
+            }
+            Cost cost = reached_[p];
+            const auto& offsets = neighborhood_.offsets(p);
+            const auto& reverse = reverse_[p.x % Neighborhood::period];
+            for (std::size_t i = 0; i < Neighborhood::size; ++i) {
+                Point offset = offsets[i];
+                Point q = p + offset;
+                if (!isInsideMatrix(costs, q) || !isPassable(costs[q])) {
+                    continue;
+                }
+                if (Traits::checkCorners && offset.x != 0 && offset.y != 0 &&
+                        (!isPassable(costs[Point{q.x, p.y}]) ||
+                         !isPassable(costs[Point{p.x, q.y}]))) {
+                    continue;
+                }
+                Cost newCost = cost + costs[q];
+                std::uint32_t& state = state_[q];
+                if (state == settled ||
+                        (state == open && !(newCost < reached_[q]))) {
+                    continue;
+                }
+                state = open;
+                reached_[q] = newCost;
+                parents_[q] = reverse[i];
+                queue.push(key(newCost, q), index(q));
+            }
+        }
+        return false;
+    }
+
+    bool run(const Matrix<Cost>& costs, const Point* goal, std::true_type) {
+        if (maxCellCost_ > 0 && maxCellCost_ <= maxBucketCost) {
+            buckets_.reset(maxCellCost_ + (goal ? heuristicWeight_ : 0) + 1);
+            return search(buckets_, costs, goal);
+        }
+        radixHeap_.clear();
+        return search(radixHeap_, costs, goal);
+    }
+
+    bool run(const Matrix<Cost>& costs, const Point* goal, std::false_type) {
+        heap_.clear();
+        return search(heap_, costs, goal);
+    }
+
+public:
+    explicit PathFinder(const Neighborhood& neighborhood = Neighborhood()):
+        neighborhood_(neighborhood)
+    {
+        for (int variant = 0; variant < Neighborhood::period; ++variant) {
+            const auto& offsets = neighborhood_.offsets(Point{variant, 0});
+            for (std::size_t i = 0; i < Neighborhood::size; ++i) {
+                const auto& otherOffsets = neighborhood_.offsets(
+                        Point{variant, 0} + offsets[i]);
+                auto found = std::find(otherOffsets.begin(),
+                        otherOffsets.end(), -offsets[i]);
+                assert(found != otherOffsets.end());
+                reverse_[variant][i] = found - otherOffsets.begin();
+            }
+        }
+    }
+
+    // The heuristic is the number of steps to the goal multiplied by this
+    // weight. Paths are shortest if it is at most the cost of the cheapest
+    // passable cell, which must hold for integral costs. 0 makes A* the same
+    // as Dijkstra's algorithm. The default is 1.
+    void setHeuristicWeight(Cost weight) { heuristicWeight_ = weight; }
+    Cost getHeuristicWeight() const { return heuristicWeight_; }
+
+    // The cost of the most expensive passable cell, or 0 if unknown. Only
+    // used to select the bucket queue.
+    void setMaxCellCost(Cost cost) { maxCellCost_ = cost; }
+    Cost getMaxCellCost() const { return maxCellCost_; }
+
+    // A* from start to goal. Returns the cost of the path, or none if goal
+    // cannot be reached.
+    boost::optional<Cost> findPath(const Matrix<Cost>& costs, Point start,
+            Point goal) {
+        prepare(costs, start);
+        assert(isInsideMatrix(costs, goal));
+        if (run(costs, &goal, std::is_integral<Cost>{})) {
+            return reached_[goal];
+        }
+        return boost::none;
+    }
+
+    // Dijkstra's algorithm from start to every reachable cell.
+    void findAll(const Matrix<Cost>& costs, Point start) {
+        prepare(costs, start);
+        run(costs, nullptr, std::is_integral<Cost>{});
+    }
+
+    // Whether the cost of the shortest path to p is known after the last
+    // search.
+    bool isSettled(Point p) const {
+        return generation_ != 0 && state_[p] == generation_ + 1;
+    }
+
+    boost::optional<Cost> cost(Point p) const {
+        if (!isSettled(p)) {
+            return boost::none;
+        }
+        return reached_[p];
+    }
+
+    // The cells of the path from the start of the last search to target,
+    // both included. Empty if target is not settled.
+    std::vector<Point> path(Point target) const {
+        std::vector<Point> result;
+        if (!isSettled(target)) {
+            return result;
+        }
+        Point p = target;
+        result.push_back(p);
+        while (p != start_) {
+            p = p + neighborhood_.offsets(p)[parents_[p]];
+            result.push_back(p);
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+    // The steps of path(target), as indices into the offsets of the cell the
+    // step is taken from. For SquareNeighborhood and HexNeighborhood these
+    // are the values of square::Direction and hex::Direction.
+    std::vector<std::size_t> directions(Point target) const {
+        std::vector<std::size_t> result;
+        if (!isSettled(target)) {
+            return result;
+        }
+        for (Point p = target; p != start_;) {
+            std::size_t parent = parents_[p];
+            result.push_back(reverse_[p.x % Neighborhood::period][parent]);
+            p = p + neighborhood_.offsets(p)[parent];
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+};
+
+template<typename Neighborhood, typename Cost>
+constexpr Cost PathFinder<Neighborhood, Cost>::impassable;
+
+template<typename Neighborhood, typename Cost>
+constexpr Cost PathFinder<Neighborhood, Cost>::maxBucketCost;
+
+// A PathFinder for the calling thread, for searches from code that does not
+// own one. Its settings are kept between calls.
+template<typename Neighborhood, typename Cost = int>
+PathFinder<Neighborhood, Cost>& threadLocalPathFinder() {
+    thread_local PathFinder<Neighborhood, Cost> pathFinder;
+    return pathFinder;
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_PATHFINDING_HPP
@@ -0,0 +1,236 @@
+#ifndef UTIL_MATRIX_PERSISTENTMATRIX_HPP
+#define UTIL_MATRIX_PERSISTENTMATRIX_HPP
+
+#include "Matrix.hpp"
+#include "WriteProxy.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace util {
+namespace matrix {
+
+namespace detail {
+
+// A reference counted tile. Unlike std::shared_ptr::use_count(), isUnique()
+// is an acquire operation that synchronizes with the owners that released
+// the tile, so their reads of the tile happen before writes made in place
+// after isUnique() returned true.
+template<typename T>
+class SharedTile {
+    struct Data {
+        std::atomic<std::size_t> owners;
+        std::vector<T> cells;
+    };
+    Data* data_ = nullptr;
+
+    explicit SharedTile(std::vector<T>&& cells):
+        data_(new Data{{1}, std::move(cells)})
+    {}
+
+    void release() {
+        if (data_ && data_->owners.fetch_sub(1,
+                std::memory_order_acq_rel) == 1) {
+            delete data_;
+        }
+    }
+
+public:
+    SharedTile() = default;
+    SharedTile(std::size_t size, const T& value):
+        SharedTile(std::vector<T>(size, value))
+    {}
+    SharedTile(const SharedTile& other): data_(other.data_) {
+        if (data_) {
+            data_->owners.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    SharedTile(SharedTile&& other) noexcept : data_(other.data_) {
+        other.data_ = nullptr;
+    }
+    SharedTile& operator=(SharedTile other) noexcept {
+        std::swap(data_, other.data_);
+        return *this;
+    }
+    ~SharedTile() { release(); }
+
+    // A new tile with the same cells.
+    SharedTile copy() const { return SharedTile{std::vector<T>(**this)}; }
+
+    bool isUnique() const {
+        return data_->owners.load(std::memory_order_acquire) == 1;
+    }
+
+    std::vector<T>& operator*() { return data_->cells; }
+    const std::vector<T>& operator*() const { return data_->cells; }
+
+    bool operator==(const SharedTile& other) const {
+        return data_ == other.data_;
+    }
+};
+
+} // namespace detail
+
+// A matrix stored as reference counted tiles of tileSize x tileSize cells.
+// Copying only copies the tile pointers; a tile is copied when it is first
+// written while shared. A freshly constructed or filled matrix shares one
+// tile between all positions. Writes go through set() or the proxy returned
+// by operator[].
+//
+// Different PersistentMatrix objects sharing tiles may be used from
+// different threads, the same object may not.
+template<typename T, std::size_t tileSize = 16>
+class PersistentMatrix {
+    static_assert(tileSize != 0 && (tileSize & (tileSize - 1)) == 0,
+            "Tile size must be a power of two.");
+
+    typedef std::vector<T> Tile;
+    typedef detail::SharedTile<T> TilePtr;
+
+    static constexpr std::size_t tileArea = tileSize * tileSize;
+
+    std::size_t width_ = 0, height_ = 0, tilesPerRow_ = 0;
+    std::vector<TilePtr> tiles_;
+
+    static std::size_t tileCount(std::size_t size) {
+        return (size + tileSize - 1) / tileSize;
+    }
+
+    std::size_t tileIndex(Point p) const {
+        return (p.y / tileSize) * tilesPerRow_ + p.x / tileSize;
+    }
+
+    static std::size_t cellIndex(Point p) {
+        return (p.y % tileSize) * tileSize + p.x % tileSize;
+    }
+
+public:
+    typedef T valueType;
+    typedef WriteProxy<PersistentMatrix> reference;
+    typedef typename Tile::const_reference const_reference;
+
+    PersistentMatrix() = default;
+
+    PersistentMatrix(std::size_t width, std::size_t height,
+            const T& defValue = T())
+    {
+        reset(width, height, defValue);
+    }
+
+    template<typename U, typename Allocator>
+    explicit PersistentMatrix(const Matrix<U, Allocator>& other):
+        PersistentMatrix(other.width(), other.height())
+    {
+        static_assert(std::is_convertible<U, T>::value,
+                "Cannot convert between matrices of incompatible types.");
+        for (TilePtr& tile : tiles_) {
+            tile = TilePtr{tileArea, T()};
+        }
+        for (Point p : matrixRange(other)) {
+            (*tiles_[tileIndex(p)])[cellIndex(p)] = other[p];
+        }
+    }
+
+    reference operator[](Point p) {
+        assert(isInsideMatrix(*this, p));
+        return reference{*this, p};
+    }
+    const_reference operator[](Point p) const {
+        assert(isInsideMatrix(*this, p));
+        return (*tiles_[tileIndex(p)])[cellIndex(p)];
+    }
+
+    void set(Point p, const T& value) {
+        assert(isInsideMatrix(*this, p));
+        TilePtr& tile = tiles_[tileIndex(p)];
+        if (!tile.isUnique()) {
+            tile = tile.copy();
+        }
+        (*tile)[cellIndex(p)] = value;
+    }
+
+    std::size_t size() const { return width_ * height_; }
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+
+    // The number of tiles, and the number of those that are also referenced
+    // by other matrices or by other positions of this one.
+    std::size_t tileCount() const { return tiles_.size(); }
+    std::size_t sharedTileCount() const {
+        return std::count_if(tiles_.begin(), tiles_.end(),
+                [](const TilePtr& tile) { return !tile.isUnique(); });
+    }
+
+    void reset(std::size_t newWidth, std::size_t newHeight,
+            const T& defValue = T())
+    {
+        width_ = newWidth;
+        height_ = newHeight;
+        tilesPerRow_ = tileCount(width_);
+        tiles_.assign(tilesPerRow_ * tileCount(height_), TilePtr{});
+        fill(defValue);
+    }
+    void fill(const T& value)
+    {
+        if (!tiles_.empty()) {
+            std::fill(tiles_.begin(), tiles_.end(),
+                    TilePtr{tileArea, value});
+        }
+    }
+    void clear()
+    {
+        tiles_.clear();
+        width_ = 0;
+        height_ = 0;
+        tilesPerRow_ = 0;
+    }
+
+    Matrix<T> toMatrix() const {
+        Matrix<T> result{width_, height_};
+        for (Point p : matrixRange(result)) {
+            result[p] = (*this)[p];
+        }
+        return result;
+    }
+
+    // Shared tiles are not compared cell by cell.
+    bool operator==(const PersistentMatrix& other) const
+    {
+        if (width_ != other.width_ || height_ != other.height_) {
+            return false;
+        }
+        for (std::size_t i = 0; i < tiles_.size(); ++i) {
+            if (tiles_[i] == other.tiles_[i]) {
+                continue;
+            }
+            Point origin((i % tilesPerRow_) * tileSize,
+                    (i / tilesPerRow_) * tileSize);
+            Point end(std::min(origin.x + tileSize, width_),
+                    std::min(origin.y + tileSize, height_));
+            for (Point p : PointRange{origin, end}) {
+                if (!((*this)[p] == other[p])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+
+template<typename T, std::size_t tileSize>
+constexpr std::size_t PersistentMatrix<T, tileSize>::tileArea;
+
+template<typename T, std::size_t tileSize>
+inline bool operator!=(const PersistentMatrix<T, tileSize>& lhs,
+        const PersistentMatrix<T, tileSize>& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_PERSISTENTMATRIX_HPP
@@ -0,0 +1,24 @@
+#ifndef UTIL_MATRIX_PMRMATRIX_HPP
+#define UTIL_MATRIX_PMRMATRIX_HPP
+
+#include "Matrix.hpp"
+
+#include <boost/container/pmr/polymorphic_allocator.hpp>
+
+// Matrices with their storage in a memory_resource, for example a
+// monotonic_buffer_resource that is released at once after a search
+// iteration. Needs linking with boost_container.
+
+namespace util {
+namespace matrix {
+namespace pmr {
+
+template<typename T>
+using Matrix = matrix::Matrix<T,
+        boost::container::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_PMRMATRIX_HPP
@@ -3,6 +3,7 @@
 
 #include <boost/functional/hash.hpp>
 
+#include <algorithm>
 #include <ostream>
 #include <vector>
 #include <stddef.h>
@@ -90,6 +91,12 @@ inline int distance(Point p1, Point p2) {
     return abs(d.x) + abs(d.y);
 }
 
+// The number of steps between the points when diagonal steps are allowed.
+inline int chebyshevDistance(Point p1, Point p2) {
+    auto d = p1 - p2;
+    return std::max(abs(d.x), abs(d.y));
+}
+
 inline
 long distanceSquare(Point p1, Point p2) {
     Point difference = p1 - p2;
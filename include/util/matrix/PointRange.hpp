@@ -30,9 +30,12 @@ public:
 
     iterator begin() const;
     iterator end() const;
+    Point beginPoint() const { return begin_; }
+    Point endPoint() const { return end_; }
+    bool empty() const { return begin_.x >= end_.x || begin_.y >= end_.y; }
     Point  front() const
     {
-        if (begin_ == end_) {
+        if (empty()) {
             BOOST_THROW_EXCEPTION(std::out_of_range(
                     "front() cannot be called on empty PointRange."));
         }
@@ -40,7 +43,7 @@ public:
     }
     Point back() const
     {
-        if (begin_ == end_) {
+        if (empty()) {
             BOOST_THROW_EXCEPTION(std::out_of_range(
                     "back() cannot be called on empty PointRange."));
         }
@@ -99,7 +102,7 @@ private:
 inline
 PointRange::iterator PointRange::begin() const
 {
-    return iterator(*this, begin_);
+    return empty() ? end() : iterator(*this, begin_);
 }
 
 inline
@@ -0,0 +1,121 @@
+#ifndef UTIL_MATRIX_ROLLINGMATRIX_HPP
+#define UTIL_MATRIX_ROLLINGMATRIX_HPP
+
+#include "Matrix.hpp"
+#include "MatrixIO.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <istream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+namespace util {
+namespace matrix {
+
+// Keeps the last capacity rows of a stream of rows in a circular buffer, for
+// processing matrices that do not fit in memory row by row. Rows are
+// addressed with absolute y coordinates: the first pushed row is y = 0, and
+// only rows in [firstRow(), endRow()) are available.
+template<typename T>
+class RollingMatrix {
+    Matrix<T> rows_;
+    T defaultValue_;
+    int endRow_ = 0;
+    std::size_t rowCount_ = 0;
+
+    T* rowData(int y) {
+        return rows_.data() + (y % rows_.height()) * rows_.width();
+    }
+
+    const T* rowData(int y) const {
+        return rows_.data() + (y % rows_.height()) * rows_.width();
+    }
+
+public:
+    typedef T valueType;
+    typedef T& reference;
+    typedef const T& const_reference;
+
+    RollingMatrix(std::size_t width, std::size_t capacity,
+            const T& defValue = T()):
+        rows_(width, capacity, defValue), defaultValue_(defValue)
+    {
+        assert(capacity != 0);
+    }
+
+    reference operator[](Point p) {
+        assert(p.x >= 0 && p.x < static_cast<int>(width()) && contains(p.y));
+        return rowData(p.y)[p.x];
+    }
+    const_reference operator[](Point p) const {
+        assert(p.x >= 0 && p.x < static_cast<int>(width()) && contains(p.y));
+        return rowData(p.y)[p.x];
+    }
+
+    T* row(int y) {
+        assert(contains(y));
+        return rowData(y);
+    }
+    const T* row(int y) const {
+        assert(contains(y));
+        return rowData(y);
+    }
+
+    std::size_t width() const { return rows_.width(); }
+    std::size_t capacity() const { return rows_.height(); }
+    std::size_t rowCount() const { return rowCount_; }
+    int firstRow() const { return endRow_ - static_cast<int>(rowCount_); }
+    int endRow() const { return endRow_; }
+    bool contains(int y) const { return y >= firstRow() && y < endRow_; }
+
+    // Adds a row filled with the default value as row endRow(), dropping the
+    // oldest row if the buffer is full. Returns the new row.
+    T* advance() {
+        T* result = rowData(endRow_);
+        std::fill(result, result + width(), defaultValue_);
+        ++endRow_;
+        rowCount_ = std::min(rowCount_ + 1, capacity());
+        return result;
+    }
+
+    // Adds a row from the range. Missing elements get the default value,
+    // elements beyond width() are ignored, like in loadRow().
+    template<typename Range>
+    void pushRow(const Range& values) {
+        T* target = advance();
+        std::size_t x = 0;
+        for (auto iterator = std::begin(values);
+                x < width() && iterator != std::end(values); ++iterator) {
+            target[x++] = *iterator;
+        }
+    }
+
+    // Reads one line in the format of loadMatrix() and adds it as a row.
+    // Returns false without adding anything at the end of the input or at
+    // an empty line.
+    bool loadRow(std::istream& is, char delimiter = '\n') {
+        std::string line;
+        if (!std::getline(is, line, delimiter) || line.empty()) {
+            return false;
+        }
+        T* target = advance();
+        std::istringstream ss{line};
+        for (std::size_t x = 0; x < width() && ss.good(); ++x) {
+            detail::readValue(ss, target[x]);
+        }
+        return true;
+    }
+
+    // Drops every row, the next row will be y = 0 again.
+    void clear() {
+        endRow_ = 0;
+        rowCount_ = 0;
+    }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_ROLLINGMATRIX_HPP
@@ -0,0 +1,148 @@
+#ifndef UTIL_MATRIX_SPARSEMATRIX_HPP
+#define UTIL_MATRIX_SPARSEMATRIX_HPP
+
+#include "ChunkMap.hpp"
+#include "Matrix.hpp"
+
+#include <algorithm>
+#include <assert.h>
+
+namespace util {
+namespace matrix {
+
+// A width x height matrix that only allocates the chunkSize x chunkSize
+// chunks that have been written to; all other cells have the default value.
+// Memory use is proportional to the written area, not to the dimensions.
+//
+// The non-const operator[] allocates the chunk of the cell, so read through
+// a const reference or get() to avoid that.
+template<typename T, std::size_t chunkSize = 32>
+class SparseMatrix {
+    typedef ChunkMap<T, chunkSize> Chunks;
+    std::size_t width_ = 0, height_ = 0;
+    Chunks chunks_;
+public:
+    typedef T valueType;
+    typedef typename Chunks::reference reference;
+    typedef typename Chunks::const_reference const_reference;
+    typedef typename Chunks::Chunk Chunk;
+
+    SparseMatrix() = default;
+
+    SparseMatrix(std::size_t width, std::size_t height,
+            const T& defValue = T()):
+        width_(width), height_(height), chunks_(defValue)
+    {}
+
+    reference operator[](Point p) {
+        assert(isInsideMatrix(*this, p));
+        return chunks_.get(p);
+    }
+    const_reference operator[](Point p) const {
+        return get(p);
+    }
+    const_reference get(Point p) const {
+        assert(isInsideMatrix(*this, p));
+        return chunks_.get(p);
+    }
+
+    std::size_t size() const { return width_ * height_; }
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    const T& defaultValue() const { return chunks_.defaultValue(); }
+    std::size_t chunkCount() const { return chunks_.chunkCount(); }
+
+    // Calls function(origin, chunk) for every allocated chunk, in no
+    // particular order. origin is the position of the first cell of the
+    // chunk. Chunks at the right and bottom edges may extend beyond the
+    // matrix; those cells have the default value.
+    template<typename Function>
+    void forEachChunk(Function function) const {
+        chunks_.forEachChunk([&function](Point chunk, const Chunk& data) {
+                    function(Chunks::chunkOrigin(chunk), data);
+                });
+    }
+
+    // Frees the chunks that only contain the default value.
+    void compact() { chunks_.compact(); }
+
+    void reset(std::size_t newWidth, std::size_t newHeight,
+            const T& defValue = T()) {
+        width_ = newWidth;
+        height_ = newHeight;
+        chunks_ = Chunks{defValue};
+    }
+    void clear() {
+        reset(0, 0, defaultValue());
+    }
+
+    Matrix<T> toMatrix() const {
+        Matrix<T> result{width_, height_, defaultValue()};
+        forEachChunk([this, &result](Point origin, const Chunk& chunk) {
+                    for (Point p : matrixRange(chunk)) {
+                        if (isInsideMatrix(result, origin + p)) {
+                            result[origin + p] = chunk[p];
+                        }
+                    }
+                });
+        return result;
+    }
+
+    // Only the allocated chunks are compared. If the default values differ,
+    // every cell must also be covered by a chunk of either side.
+    bool operator==(const SparseMatrix& other) const {
+        if (width_ != other.width_ || height_ != other.height_) {
+            return false;
+        }
+        if (!chunksEqual(*this, other) || !chunksEqual(other, *this)) {
+            return false;
+        }
+        return defaultValue() == other.defaultValue() ||
+                coveredCellCount(other) == size();
+    }
+
+private:
+    // Whether the cells of the chunks of lhs are equal to the same cells of
+    // rhs.
+    static bool chunksEqual(const SparseMatrix& lhs, const SparseMatrix& rhs) {
+        bool result = true;
+        lhs.forEachChunk([&](Point origin, const Chunk& chunk) {
+                    for (Point p : matrixRange(chunk)) {
+                        if (result && isInsideMatrix(lhs, origin + p) &&
+                                !(chunk[p] == rhs[origin + p])) {
+                            result = false;
+                        }
+                    }
+                });
+        return result;
+    }
+
+    // The number of cells of the matrix in the chunks of this or other.
+    std::size_t coveredCellCount(const SparseMatrix& other) const {
+        std::size_t result = 0;
+        auto count = [this, &result](Point origin) {
+            Point end = origin + Point{chunkSize, chunkSize};
+            result += static_cast<std::size_t>(
+                    std::min<int>(end.x, width_) - origin.x) *
+                    (std::min<int>(end.y, height_) - origin.y);
+        };
+        forEachChunk([&count](Point origin, const Chunk&) { count(origin); });
+        other.chunks_.forEachChunk([&](Point chunk, const Chunk&) {
+                    if (!chunks_.findChunk(chunk)) {
+                        count(Chunks::chunkOrigin(chunk));
+                    }
+                });
+        return result;
+    }
+};
+
+template<typename T, std::size_t chunkSize>
+inline bool operator!=(const SparseMatrix<T, chunkSize>& lhs,
+        const SparseMatrix<T, chunkSize>& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_SPARSEMATRIX_HPP
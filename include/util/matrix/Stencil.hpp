@@ -0,0 +1,270 @@
+#ifndef UTIL_MATRIX_STENCIL_HPP
+#define UTIL_MATRIX_STENCIL_HPP
+
+#include "Neighborhoods.hpp"
+#include "ParallelAlgorithms.hpp"
+#include "Point.hpp"
+
+#include <algorithm>
+#include <array>
+#include <assert.h>
+#include <type_traits>
+#include <vector>
+
+// Applies a kernel to every cell of a matrix and its neighbors (see
+// Neighborhoods.hpp), writing the results into another matrix:
+//
+//     output[p] = kernel(input[p], {input[p + offsets[0]], ...})
+//
+// The neighbor values are passed as a std::array in the order of the
+// neighborhood. Cells that are at least one cell away from the border are
+// computed through precomputed pointer offsets without bounds checks, and
+// for WeightedSum on square neighborhoods the rows are processed one
+// neighbor at a time in loops the compiler can vectorize. Neighbors outside
+// the matrix are resolved according to the BorderMode.
+//
+// The matrices must provide data() and stride() (Matrix, AlignedMatrix,
+// MatrixView), have the same dimensions and must not overlap.
+
+namespace util {
+namespace matrix {
+
+enum class BorderMode {
+    // The nearest cell inside the matrix.
+    clamp,
+    // A given value.
+    constant,
+    // The cell on the opposite side, as if the matrix was a torus.
+    wrap
+};
+
+// centerWeight * center + sum(weights[i] * neighbors[i]), computed in
+// Weight.
+template<typename Weight, std::size_t size>
+struct WeightedSum {
+    Weight centerWeight;
+    std::array<Weight, size> weights;
+
+    template<typename T>
+    Weight operator()(const T& center,
+            const std::array<T, size>& neighbors) const {
+        Weight result = centerWeight * center;
+        for (std::size_t i = 0; i < size; ++i) {
+            result += weights[i] * neighbors[i];
+        }
+        return result;
+    }
+};
+
+// The same weight for every neighbor of the neighborhood.
+template<typename Neighborhood, typename Weight>
+WeightedSum<Weight, Neighborhood::size> uniformWeights(
+        const Neighborhood& /*neighborhood*/, Weight centerWeight,
+        Weight neighborWeight) {
+    WeightedSum<Weight, Neighborhood::size> result;
+    result.centerWeight = centerWeight;
+    result.weights.fill(neighborWeight);
+    return result;
+}
+
+// The minimum of the cell and its neighbors.
+struct MinKernel {
+    template<typename T, std::size_t size>
+    T operator()(const T& center, const std::array<T, size>& neighbors) const {
+        T result = center;
+        for (const T& value : neighbors) {
+            result = value < result ? value : result;
+        }
+        return result;
+    }
+};
+
+// The maximum of the cell and its neighbors.
+struct MaxKernel {
+    template<typename T, std::size_t size>
+    T operator()(const T& center, const std::array<T, size>& neighbors) const {
+        T result = center;
+        for (const T& value : neighbors) {
+            result = result < value ? value : result;
+        }
+        return result;
+    }
+};
+
+namespace detail {
+
+template<typename Input>
+using StencilValue = std::remove_const_t<typename Input::valueType>;
+
+inline int wrapCoordinate(int value, int size) {
+    value %= size;
+    return value < 0 ? value + size : value;
+}
+
+template<typename Input, typename Neighborhood, typename Kernel>
+auto applyKernelAtBorder(const Input& input, const Neighborhood& neighborhood,
+        const Kernel& kernel, BorderMode border,
+        const StencilValue<Input>& borderValue, Point p) {
+    using T = StencilValue<Input>;
+    int width = input.width();
+    int height = input.height();
+    const auto& offsets = neighborhood.offsets(p);
+    std::array<T, Neighborhood::size> values;
+    for (std::size_t i = 0; i < Neighborhood::size; ++i) {
+        Point q = p + offsets[i];
+        if (q.x < 0 || q.y < 0 || q.x >= width || q.y >= height) {
+            switch (border) {
+            case BorderMode::constant:
+                values[i] = borderValue;
+                continue;
+            case BorderMode::clamp:
+                q.x = std::min(std::max(q.x, 0), width - 1);
+                q.y = std::min(std::max(q.y, 0), height - 1);
+                break;
+            case BorderMode::wrap:
+                q.x = wrapCoordinate(q.x, width);
+                q.y = wrapCoordinate(q.y, height);
+                break;
+            }
+        }
+        values[i] = input.data()[q.y * input.stride() + q.x];
+    }
+    return kernel(input.data()[p.y * input.stride() + p.x], values);
+}
+
+// Pointer offsets of the neighbors, for each x % period.
+template<typename Neighborhood>
+std::array<std::array<std::ptrdiff_t, Neighborhood::size>,
+        Neighborhood::period>
+linearOffsets(const Neighborhood& neighborhood, std::size_t stride) {
+    std::array<std::array<std::ptrdiff_t, Neighborhood::size>,
+            Neighborhood::period> result;
+    for (int variant = 0; variant < Neighborhood::period; ++variant) {
+        const auto& offsets = neighborhood.offsets(Point{variant, 0});
+        for (std::size_t i = 0; i < Neighborhood::size; ++i) {
+            result[variant][i] = static_cast<std::ptrdiff_t>(offsets[i].y) *
+                    static_cast<std::ptrdiff_t>(stride) + offsets[i].x;
+        }
+    }
+    return result;
+}
+
+template<typename T, typename Out, typename Neighborhood, typename Kernel>
+void applyKernelToInterior(const T* in, Out* out, std::size_t begin,
+        std::size_t end, const Neighborhood& neighborhood,
+        const Kernel& kernel, std::size_t stride) {
+    auto offsets = linearOffsets(neighborhood, stride);
+    std::array<T, Neighborhood::size> values;
+    for (std::size_t x = begin; x < end; ++x) {
+        const auto& variant = offsets[x % Neighborhood::period];
+        const T* center = in + x;
+        for (std::size_t i = 0; i < Neighborhood::size; ++i) {
+            values[i] = center[variant[i]];
+        }
+        out[x] = kernel(*center, values);
+    }
+}
+
+// Weighted sums over neighborhoods that are the same for every cell are
+// accumulated one neighbor at a time over the whole row.
+template<typename T, typename Out, typename Neighborhood, typename Weight,
+        std::size_t size>
+std::enable_if_t<Neighborhood::period == 1> applyKernelToInterior(
+        const T* in, Out* out, std::size_t begin, std::size_t end,
+        const Neighborhood& neighborhood,
+        const WeightedSum<Weight, size>& kernel, std::size_t stride) {
+    auto offsets = linearOffsets(neighborhood, stride)[0];
+    thread_local std::vector<Weight> buffer;
+    buffer.resize(end - begin);
+    Weight* sums = buffer.data();
+    const T* row = in + begin;
+    for (std::size_t x = 0; x < end - begin; ++x) {
+        sums[x] = kernel.centerWeight * row[x];
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        const T* neighbor = row + offsets[i];
+        Weight weight = kernel.weights[i];
+        for (std::size_t x = 0; x < end - begin; ++x) {
+            sums[x] += weight * neighbor[x];
+        }
+    }
+    Out* target = out + begin;
+    for (std::size_t x = 0; x < end - begin; ++x) {
+        target[x] = sums[x];
+    }
+}
+
+template<typename Input, typename Output, typename Neighborhood,
+        typename Kernel>
+void applyStencilToRows(const Input& input, Output& output,
+        const Neighborhood& neighborhood, const Kernel& kernel,
+        BorderMode border, const StencilValue<Input>& borderValue,
+        std::size_t yBegin, std::size_t yEnd) {
+    std::size_t width = input.width();
+    std::size_t height = input.height();
+    for (std::size_t y = yBegin; y < yEnd; ++y) {
+        auto out = output.data() + y * output.stride();
+        bool interiorRow = y >= 1 && y + 1 < height && width > 2;
+        std::size_t interiorBegin = interiorRow ? 1 : width;
+        std::size_t interiorEnd = interiorRow ? width - 1 : width;
+        for (std::size_t x = 0; x < interiorBegin; ++x) {
+            out[x] = applyKernelAtBorder(input, neighborhood, kernel, border,
+                    borderValue, Point(x, y));
+        }
+        if (interiorRow) {
+            applyKernelToInterior(input.data() + y * input.stride(), out,
+                    interiorBegin, interiorEnd, neighborhood, kernel,
+                    input.stride());
+        }
+        for (std::size_t x = interiorEnd; x < width; ++x) {
+            out[x] = applyKernelAtBorder(input, neighborhood, kernel, border,
+                    borderValue, Point(x, y));
+        }
+    }
+}
+
+template<typename Input, typename Output>
+void checkStencilArguments(const Input& input, const Output& output) {
+    assert(input.width() == output.width() &&
+            input.height() == output.height());
+    assert(static_cast<const void*>(input.data()) !=
+            static_cast<const void*>(output.data()) ||
+            input.width() * input.height() == 0);
+    (void)input;
+    (void)output;
+}
+
+} // namespace detail
+
+template<typename Input, typename Output, typename Neighborhood,
+        typename Kernel>
+void applyStencil(const Input& input, Output&& output,
+        const Neighborhood& neighborhood, Kernel kernel,
+        BorderMode border = BorderMode::clamp,
+        const detail::StencilValue<Input>& borderValue = {}) {
+    detail::checkStencilArguments(input, output);
+    detail::applyStencilToRows(input, output, neighborhood, kernel, border,
+            borderValue, 0, input.height());
+}
+
+// Processes bands of grain rows on the thread pool, see
+// parallelForBands().
+template<typename Input, typename Output, typename Neighborhood,
+        typename Kernel>
+void applyStencil(ThreadPool& threadPool, const Input& input,
+        Output&& output, const Neighborhood& neighborhood, Kernel kernel,
+        BorderMode border = BorderMode::clamp,
+        const detail::StencilValue<Input>& borderValue = {},
+        std::size_t grain = 0) {
+    detail::checkStencilArguments(input, output);
+    parallelForBands(threadPool, input.height(), grain,
+            [&](std::size_t begin, std::size_t end) {
+                detail::applyStencilToRows(input, output, neighborhood,
+                        kernel, border, borderValue, begin, end);
+            });
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_STENCIL_HPP
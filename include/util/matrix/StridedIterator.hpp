@@ -0,0 +1,66 @@
+#ifndef UTIL_MATRIX_STRIDEDITERATOR_HPP
+#define UTIL_MATRIX_STRIDEDITERATOR_HPP
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace util {
+namespace matrix {
+
+// Iterates over the cells of row-major storage where consecutive rows are
+// `stride` elements apart, skipping the padding at the end of each row.
+template<typename T>
+class StridedIterator : public boost::iterator_facade<
+        StridedIterator<T>, T, boost::bidirectional_traversal_tag> {
+public:
+    StridedIterator() : ptr_(nullptr), column_(0), width_(0), stride_(0) {}
+
+    StridedIterator(T* ptr, std::size_t width, std::size_t stride) :
+            ptr_(ptr), column_(0), width_(width), stride_(stride) {}
+
+    template<typename U, typename = std::enable_if_t<
+            std::is_convertible<U*, T*>::value>>
+    StridedIterator(const StridedIterator<U>& other) :
+            ptr_(other.ptr_), column_(other.column_),
+            width_(other.width_), stride_(other.stride_) {}
+
+private:
+    template<typename U> friend class StridedIterator;
+    friend class boost::iterator_core_access;
+
+    T& dereference() const { return *ptr_; }
+
+    template<typename U>
+    bool equal(const StridedIterator<U>& other) const {
+        return ptr_ == other.ptr_;
+    }
+
+    void increment() {
+        ++ptr_;
+        if (++column_ == width_) {
+            ptr_ += stride_ - width_;
+            column_ = 0;
+        }
+    }
+
+    void decrement() {
+        if (column_ == 0) {
+            ptr_ -= stride_ - width_;
+            column_ = width_;
+        }
+        --ptr_;
+        --column_;
+    }
+
+    T* ptr_;
+    std::size_t column_;
+    std::size_t width_;
+    std::size_t stride_;
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_STRIDEDITERATOR_HPP
@@ -0,0 +1,234 @@
+#ifndef UTIL_MATRIX_SUMMEDAREATABLE_HPP
+#define UTIL_MATRIX_SUMMEDAREATABLE_HPP
+
+#include "Matrix.hpp"
+#include "ParallelAlgorithms.hpp"
+#include "PointRange.hpp"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace util {
+namespace matrix {
+
+namespace detail {
+
+template<typename T, typename Enable = void>
+struct SummedAreaType {
+    typedef T type;
+};
+
+template<typename T>
+struct SummedAreaType<T, std::enable_if_t<std::is_integral<T>::value &&
+        std::is_signed<T>::value>> {
+    typedef std::int64_t type;
+};
+
+template<typename T>
+struct SummedAreaType<T, std::enable_if_t<std::is_integral<T>::value &&
+        std::is_unsigned<T>::value>> {
+    typedef std::uint64_t type;
+};
+
+template<typename T>
+struct SummedAreaType<T, std::enable_if_t<
+        std::is_floating_point<T>::value>> {
+    typedef double type;
+};
+
+} // namespace detail
+
+// Sums of every rectangle of a matrix in O(1). The table stores the sum of
+// the rectangle [0, 0) - (x, y) for every point, with an extra row and column
+// of zeros in front so that queries need no special cases at the edges.
+//
+// Sums are computed in Sum, which defaults to 64 bit integers for integral
+// types and double for floating point types. The source matrix must provide
+// data() and stride() (Matrix, AlignedMatrix, MatrixView).
+template<typename T, typename Sum = typename detail::SummedAreaType<T>::type>
+class SummedAreaTable {
+    Matrix<Sum> table_;
+
+    Sum* row(std::size_t y) { return table_.data() + y * table_.stride(); }
+    const Sum* row(std::size_t y) const {
+        return table_.data() + y * table_.stride();
+    }
+
+    // Fills rows [begin, end) of the table with sums relative to row begin,
+    // i.e. as if the source started at row begin.
+    template<typename Source>
+    void buildRows(const Source& source, std::size_t begin, std::size_t end) {
+        std::size_t width = source.width();
+        const Sum* previous = nullptr;
+        for (std::size_t y = begin; y < end; ++y) {
+            const auto* in = source.data() + y * source.stride();
+            Sum* out = row(y + 1);
+            Sum rowSum = Sum();
+            out[0] = Sum();
+            if (previous) {
+                for (std::size_t x = 0; x < width; ++x) {
+                    rowSum += in[x];
+                    out[x + 1] = previous[x + 1] + rowSum;
+                }
+            } else {
+                for (std::size_t x = 0; x < width; ++x) {
+                    rowSum += in[x];
+                    out[x + 1] = rowSum;
+                }
+            }
+            previous = out;
+        }
+    }
+
+    PointRange clip(const PointRange& range) const {
+        Point limit{static_cast<int>(width()), static_cast<int>(height())};
+        Point begin = range.beginPoint();
+        Point end = range.endPoint();
+        return PointRange{
+                Point{std::max(begin.x, 0), std::max(begin.y, 0)},
+                Point{std::min(end.x, limit.x), std::min(end.y, limit.y)}};
+    }
+
+public:
+    typedef T valueType;
+    typedef Sum sumType;
+
+    SummedAreaTable() = default;
+
+    template<typename Source>
+    explicit SummedAreaTable(const Source& source) {
+        rebuild(source);
+    }
+
+    template<typename Source>
+    SummedAreaTable(ThreadPool& threadPool, const Source& source,
+            std::size_t grain = 0) {
+        rebuild(threadPool, source, grain);
+    }
+
+    std::size_t width() const {
+        return table_.width() == 0 ? 0 : table_.width() - 1;
+    }
+    std::size_t height() const {
+        return table_.height() == 0 ? 0 : table_.height() - 1;
+    }
+
+    template<typename Source>
+    void rebuild(const Source& source) {
+        table_.reset(source.width() + 1, source.height() + 1);
+        buildRows(source, 0, source.height());
+    }
+
+    // Each band of grain rows is summed independently, then the last row of
+    // every band is carried into the bands after it.
+    template<typename Source>
+    void rebuild(ThreadPool& threadPool, const Source& source,
+            std::size_t grain = 0) {
+        std::size_t height = source.height();
+        table_.reset(source.width() + 1, height + 1);
+        if (grain == 0) {
+            std::size_t bands =
+                    std::max<std::size_t>(threadPool.getNumThreads(), 1) * 4;
+            grain = std::max<std::size_t>((height + bands - 1) / bands, 1);
+        }
+        parallelForBands(threadPool, height, grain,
+                [&](std::size_t begin, std::size_t end) {
+                    buildRows(source, begin, end);
+                });
+
+        std::size_t numBands = (height + grain - 1) / grain;
+        std::size_t tableWidth = table_.width();
+        // carries[b] is the last row of the full table before band b.
+        std::vector<Sum> carries(numBands * tableWidth, Sum());
+        for (std::size_t band = 1; band < numBands; ++band) {
+            const Sum* last = row(band * grain);
+            const Sum* previousCarry = &carries[(band - 1) * tableWidth];
+            Sum* carry = &carries[band * tableWidth];
+            for (std::size_t x = 0; x < tableWidth; ++x) {
+                carry[x] = previousCarry[x] + last[x];
+            }
+        }
+        parallelForBands(threadPool, height, grain,
+                [&](std::size_t begin, std::size_t end) {
+                    if (begin == 0) {
+                        return;
+                    }
+                    const Sum* carry = &carries[(begin / grain) * tableWidth];
+                    for (std::size_t y = begin; y < end; ++y) {
+                        Sum* out = row(y + 1);
+                        for (std::size_t x = 0; x < tableWidth; ++x) {
+                            out[x] += carry[x];
+                        }
+                    }
+                });
+    }
+
+    // Recomputes the table after the cells inside dirty have changed in
+    // source. Every sum below and to the right of the beginning of dirty
+    // depends on them, so the cost is proportional to that area, not to the
+    // area of dirty.
+    template<typename Source>
+    void update(const Source& source, const PointRange& dirty) {
+        assert(source.width() == width() && source.height() == height());
+        PointRange clipped = clip(dirty);
+        if (clipped.empty()) {
+            return;
+        }
+        std::size_t beginX = clipped.beginPoint().x;
+        std::size_t beginY = clipped.beginPoint().y;
+        std::size_t width = source.width();
+        for (std::size_t y = beginY; y < source.height(); ++y) {
+            const auto* in = source.data() + y * source.stride();
+            const Sum* previous = row(y);
+            Sum* out = row(y + 1);
+            Sum rowSum = out[beginX] - previous[beginX];
+            for (std::size_t x = beginX; x < width; ++x) {
+                rowSum += in[x];
+                out[x + 1] = previous[x + 1] + rowSum;
+            }
+        }
+    }
+
+    // The sum of the cells of range that are inside the matrix.
+    Sum sum(const PointRange& range) const {
+        PointRange clipped = clip(range);
+        if (clipped.empty()) {
+            return Sum();
+        }
+        Point begin = clipped.beginPoint();
+        Point end = clipped.endPoint();
+        const Sum* top = row(begin.y);
+        const Sum* bottom = row(end.y);
+        return bottom[end.x] - bottom[begin.x] - top[end.x] + top[begin.x];
+    }
+
+    // The number of cells of range that are inside the matrix.
+    std::size_t count(const PointRange& range) const {
+        PointRange clipped = clip(range);
+        if (clipped.empty()) {
+            return 0;
+        }
+        Point size = clipped.endPoint() - clipped.beginPoint();
+        return static_cast<std::size_t>(size.x) * size.y;
+    }
+
+    // sum(range) / count(range), or 0 if the range has no cells inside the
+    // matrix.
+    double mean(const PointRange& range) const {
+        std::size_t n = count(range);
+        return n == 0 ? 0.0 : static_cast<double>(sum(range)) / n;
+    }
+
+    Sum total() const {
+        return table_.width() == 0 || table_.height() == 0 ?
+                Sum() : row(height())[width()];
+    }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_SUMMEDAREATABLE_HPP
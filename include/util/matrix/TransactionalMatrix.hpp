@@ -0,0 +1,121 @@
+#ifndef UTIL_MATRIX_TRANSACTIONALMATRIX_HPP
+#define UTIL_MATRIX_TRANSACTIONALMATRIX_HPP
+
+#include "Matrix.hpp"
+#include "WriteProxy.hpp"
+
+#include <assert.h>
+#include <utility>
+#include <vector>
+
+namespace util {
+namespace matrix {
+
+// A matrix that records the old value of every written cell in a journal, so
+// a backtracking search can modify it in place and undo the changes instead
+// of copying it. checkpoint() marks the current state, rollback() restores a
+// marked state in time proportional to the number of writes since then.
+// commit() forgets the journal but keeps its memory for reuse.
+//
+// Writes go through set() or the proxy returned by operator[]. fill(),
+// reset() and clear() are not recorded and commit.
+template<typename T>
+class TransactionalMatrix {
+    Matrix<T> matrix_;
+    std::vector<std::pair<std::size_t, T>> journal_;
+public:
+    typedef T valueType;
+    typedef WriteProxy<TransactionalMatrix> reference;
+    typedef typename Matrix<T>::const_reference const_reference;
+    typedef typename Matrix<T>::const_iterator const_iterator;
+    typedef std::size_t Checkpoint;
+
+    TransactionalMatrix() = default;
+
+    TransactionalMatrix(std::size_t width, std::size_t height,
+            const T& defValue = T()):
+        matrix_(width, height, defValue)
+    {}
+
+    explicit TransactionalMatrix(Matrix<T> matrix):
+        matrix_(std::move(matrix))
+    {}
+
+    reference operator[](Point p) {
+        assert(isInsideMatrix(*this, p));
+        return reference{*this, p};
+    }
+    const_reference operator[](Point p) const {
+        return matrix_[p];
+    }
+
+    void set(Point p, const T& value) {
+        assert(isInsideMatrix(*this, p));
+        std::size_t index = p.y * matrix_.width() + p.x;
+        journal_.emplace_back(index, matrix_[index]);
+        matrix_[index] = value;
+    }
+
+    Checkpoint checkpoint() const { return journal_.size(); }
+
+    // Undoes every write made after the checkpoint. Later checkpoints become
+    // invalid.
+    void rollback(Checkpoint checkpoint) {
+        assert(checkpoint <= journal_.size());
+        while (journal_.size() > checkpoint) {
+            auto& entry = journal_.back();
+            matrix_[entry.first] = std::move(entry.second);
+            journal_.pop_back();
+        }
+    }
+
+    // Undoes every write since the last commit.
+    void rollback() { rollback(0); }
+
+    void commit() { journal_.clear(); }
+
+    std::size_t journalSize() const { return journal_.size(); }
+    void reserveJournal(std::size_t size) { journal_.reserve(size); }
+
+    const Matrix<T>& matrix() const { return matrix_; }
+
+    const T* data() const { return matrix_.data(); }
+    std::size_t size() const { return matrix_.size(); }
+    std::size_t width() const { return matrix_.width(); }
+    std::size_t height() const { return matrix_.height(); }
+    std::size_t stride() const { return matrix_.stride(); }
+
+    void reset(std::size_t newWidth, std::size_t newHeight,
+            const T& defValue = T()) {
+        matrix_.reset(newWidth, newHeight, defValue);
+        commit();
+    }
+    void fill(const T& value) {
+        matrix_.fill(value);
+        commit();
+    }
+    void clear() {
+        matrix_.clear();
+        commit();
+    }
+
+    bool operator==(const TransactionalMatrix& other) const {
+        return matrix_ == other.matrix_;
+    }
+
+    const_iterator begin() const { return matrix_.begin(); }
+    const_iterator end() const { return matrix_.end(); }
+    const_iterator cbegin() const { return matrix_.cbegin(); }
+    const_iterator cend() const { return matrix_.cend(); }
+};
+
+template<typename T>
+inline bool operator!=(const TransactionalMatrix<T>& lhs,
+        const TransactionalMatrix<T>& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_TRANSACTIONALMATRIX_HPP
@@ -0,0 +1,49 @@
+#ifndef UTIL_MATRIX_WRITEPROXY_HPP
+#define UTIL_MATRIX_WRITEPROXY_HPP
+
+#include "Point.hpp"
+
+namespace util {
+namespace matrix {
+
+// The reference type of matrices that need to know about every write. Reads
+// go through the const operator[] of the owner, writes call
+// owner.set(p, value).
+template<typename Owner>
+class WriteProxy {
+    Owner& owner_;
+    Point p_;
+public:
+    typedef typename Owner::valueType valueType;
+    typedef typename Owner::const_reference const_reference;
+
+    WriteProxy(Owner& owner, Point p): owner_(owner), p_(p) {}
+
+    const_reference get() const {
+        return static_cast<const Owner&>(owner_)[p_];
+    }
+
+    operator const_reference() const { return get(); }
+
+    WriteProxy& operator=(const valueType& value) {
+        owner_.set(p_, value);
+        return *this;
+    }
+
+    WriteProxy& operator=(const WriteProxy& other) {
+        return *this = other.get();
+    }
+
+    WriteProxy& operator+=(const valueType& value) {
+        return *this = get() + value;
+    }
+
+    WriteProxy& operator-=(const valueType& value) {
+        return *this = get() - value;
+    }
+};
+
+} // namespace matrix
+} // namespace util
+
+#endif // UTIL_MATRIX_WRITEPROXY_HPP
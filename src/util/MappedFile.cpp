@@ -0,0 +1,160 @@
+#include "util/MappedFile.hpp"
+
+#include <boost/throw_exception.hpp>
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace util {
+
+namespace {
+
+[[noreturn]] void throwSystemError(const std::string& what,
+        const std::string& fileName) {
+    BOOST_THROW_EXCEPTION(std::system_error(errno, std::generic_category(),
+            what + " " + fileName));
+}
+
+class FileDescriptor {
+    int fd_;
+public:
+    FileDescriptor(const std::string& fileName, int flags,
+            mode_t permissions = 0):
+        fd_(::open(fileName.c_str(), flags | O_CLOEXEC, permissions))
+    {
+        if (fd_ < 0) {
+            throwSystemError("open", fileName);
+        }
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+    ~FileDescriptor() { ::close(fd_); }
+
+    int get() const { return fd_; }
+};
+
+int getAdvice(AccessHint hint) {
+    switch (hint) {
+    case AccessHint::sequential: return MADV_SEQUENTIAL;
+    case AccessHint::random: return MADV_RANDOM;
+    case AccessHint::willNeed: return MADV_WILLNEED;
+    case AccessHint::dontNeed: return MADV_DONTNEED;
+    default: return MADV_NORMAL;
+    }
+}
+
+} // unnamed namespace
+
+MappedFile::MappedFile(const std::string& fileName, MapMode mode,
+        bool populate):
+    fileName_(fileName), mode_(mode)
+{
+    FileDescriptor fd{fileName,
+            mode == MapMode::readWrite ? O_RDWR : O_RDONLY};
+    struct stat status;
+    if (::fstat(fd.get(), &status) != 0) {
+        throwSystemError("stat", fileName);
+    }
+    size_ = status.st_size;
+    map(fd.get(), populate);
+}
+
+MappedFile MappedFile::create(const std::string& fileName, std::size_t size,
+        bool populate) {
+    FileDescriptor fd{fileName, O_RDWR | O_CREAT | O_TRUNC, 0666};
+    if (::ftruncate(fd.get(), size) != 0) {
+        throwSystemError("truncate", fileName);
+    }
+    MappedFile result;
+    result.fileName_ = fileName;
+    result.size_ = size;
+    result.mode_ = MapMode::readWrite;
+    result.map(fd.get(), populate);
+    return result;
+}
+
+void MappedFile::map(int fd, bool populate) {
+    // mmap() does not accept empty mappings.
+    if (size_ == 0) {
+        return;
+    }
+    int protection = mode_ == MapMode::readOnly ?
+            PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = mode_ == MapMode::copyOnWrite ? MAP_PRIVATE : MAP_SHARED;
+    if (populate) {
+        flags |= MAP_POPULATE;
+    }
+    void* result = ::mmap(nullptr, size_, protection, flags, fd, 0);
+    if (result == MAP_FAILED) {
+        size_ = 0;
+        throwSystemError("mmap", fileName_);
+    }
+    data_ = static_cast<char*>(result);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept:
+    fileName_(std::move(other.fileName_)),
+    data_(other.data_), size_(other.size_), mode_(other.mode_)
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fileName_ = std::move(other.fileName_);
+        data_ = other.data_;
+        size_ = other.size_;
+        mode_ = other.mode_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::advise(AccessHint hint) {
+    advise(hint, 0, size_);
+}
+
+void MappedFile::advise(AccessHint hint, std::size_t offset,
+        std::size_t length) {
+    if (data_ == nullptr || length == 0) {
+        return;
+    }
+    std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    std::size_t begin = offset / pageSize * pageSize;
+    if (::madvise(data_ + begin, offset + length - begin,
+            getAdvice(hint)) != 0) {
+        throwSystemError("madvise", fileName_);
+    }
+}
+
+void MappedFile::flush(bool wait) {
+    if (data_ == nullptr || mode_ != MapMode::readWrite) {
+        return;
+    }
+    if (::msync(data_, size_, wait ? MS_SYNC : MS_ASYNC) != 0) {
+        throwSystemError("msync", fileName_);
+    }
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) {
+        ::munmap(data_, size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+} // namespace util
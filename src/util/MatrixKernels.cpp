@@ -0,0 +1,601 @@
+#include "util/matrix/MatrixKernels.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define UTIL_MATRIX_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace util {
+namespace matrix {
+namespace kernels {
+
+namespace {
+
+SimdLevel detectSimdLevel()
+{
+#ifdef UTIL_MATRIX_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::sse2;
+    }
+#endif
+    return SimdLevel::scalar;
+}
+
+std::atomic<SimdLevel>& currentSimdLevel()
+{
+    static std::atomic<SimdLevel> level{getSupportedSimdLevel()};
+    return level;
+}
+
+} // unnamed namespace
+
+SimdLevel getSupportedSimdLevel()
+{
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+SimdLevel getSimdLevel()
+{
+    return currentSimdLevel().load(std::memory_order_relaxed);
+}
+
+void setSimdLevel(SimdLevel level)
+{
+    currentSimdLevel().store(std::min(level, getSupportedSimdLevel()),
+            std::memory_order_relaxed);
+}
+
+namespace detail {
+
+#ifdef UTIL_MATRIX_KERNELS_X86
+
+namespace {
+
+#define UTIL_SSE2 __attribute__((target("sse2")))
+#define UTIL_AVX2 __attribute__((target("avx2")))
+
+// ---------------------------------------------------------------- SSE2
+
+UTIL_SSE2 inline __m128i loadSse2(const std::int32_t* data)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+UTIL_SSE2 inline void storeSse2(std::int32_t* data, __m128i value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), value);
+}
+
+UTIL_SSE2 inline __m128i minSse2(__m128i a, __m128i b)
+{
+    __m128i greater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(greater, b),
+            _mm_andnot_si128(greater, a));
+}
+
+UTIL_SSE2 inline __m128i maxSse2(__m128i a, __m128i b)
+{
+    __m128i greater = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(greater, a),
+            _mm_andnot_si128(greater, b));
+}
+
+// Returns the lane bits of (v <comparison> x).
+UTIL_SSE2 inline int compareSse2(__m128i v, __m128i x, Comparison comparison)
+{
+    __m128i result;
+    bool invert = false;
+    switch (comparison) {
+    case Comparison::less: result = _mm_cmpgt_epi32(x, v); break;
+    case Comparison::greaterEqual:
+        result = _mm_cmpgt_epi32(x, v); invert = true; break;
+    case Comparison::greater: result = _mm_cmpgt_epi32(v, x); break;
+    case Comparison::lessEqual:
+        result = _mm_cmpgt_epi32(v, x); invert = true; break;
+    case Comparison::equal: result = _mm_cmpeq_epi32(v, x); break;
+    default: result = _mm_cmpeq_epi32(v, x); invert = true; break;
+    }
+    int bits = _mm_movemask_ps(_mm_castsi128_ps(result));
+    return invert ? bits ^ 0xF : bits;
+}
+
+UTIL_SSE2 inline int compareSse2(__m128 v, __m128 x, Comparison comparison)
+{
+    __m128 result;
+    switch (comparison) {
+    case Comparison::less: result = _mm_cmplt_ps(v, x); break;
+    case Comparison::lessEqual: result = _mm_cmple_ps(v, x); break;
+    case Comparison::equal: result = _mm_cmpeq_ps(v, x); break;
+    case Comparison::notEqual: result = _mm_cmpneq_ps(v, x); break;
+    case Comparison::greaterEqual: result = _mm_cmpge_ps(v, x); break;
+    default: result = _mm_cmpgt_ps(v, x); break;
+    }
+    return _mm_movemask_ps(result);
+}
+
+UTIL_SSE2 std::int64_t sumSse2(const std::int32_t* data, std::size_t size)
+{
+    __m128i accumulator = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i value = loadSse2(data + i);
+        __m128i sign = _mm_srai_epi32(value, 31);
+        accumulator = _mm_add_epi64(accumulator,
+                _mm_unpacklo_epi32(value, sign));
+        accumulator = _mm_add_epi64(accumulator,
+                _mm_unpackhi_epi32(value, sign));
+    }
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+    return lanes[0] + lanes[1] + sumSpan<std::int32_t>(data + i, size - i);
+}
+
+UTIL_SSE2 double sumSse2(const float* data, std::size_t size)
+{
+    __m128d accumulator1 = _mm_setzero_pd();
+    __m128d accumulator2 = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128 value = _mm_loadu_ps(data + i);
+        accumulator1 = _mm_add_pd(accumulator1, _mm_cvtps_pd(value));
+        accumulator2 = _mm_add_pd(accumulator2,
+                _mm_cvtps_pd(_mm_movehl_ps(value, value)));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, _mm_add_pd(accumulator1, accumulator2));
+    return lanes[0] + lanes[1] + sumSpan<float>(data + i, size - i);
+}
+
+UTIL_SSE2 void minMaxSse2(const std::int32_t* data, std::size_t size,
+        std::int32_t& min, std::int32_t& max)
+{
+    minMaxSpan<std::int32_t>(data, std::min<std::size_t>(size, 4), min, max);
+    __m128i minimum = _mm_set1_epi32(min);
+    __m128i maximum = _mm_set1_epi32(max);
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128i value = loadSse2(data + i);
+        minimum = minSse2(minimum, value);
+        maximum = maxSse2(maximum, value);
+    }
+    alignas(16) std::int32_t minLanes[4];
+    alignas(16) std::int32_t maxLanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(minLanes), minimum);
+    _mm_store_si128(reinterpret_cast<__m128i*>(maxLanes), maximum);
+    for (int lane = 0; lane < 4; ++lane) {
+        min = std::min(min, minLanes[lane]);
+        max = std::max(max, maxLanes[lane]);
+    }
+    for (; i < size; ++i) {
+        min = std::min(min, data[i]);
+        max = std::max(max, data[i]);
+    }
+}
+
+UTIL_SSE2 void minMaxSse2(const float* data, std::size_t size,
+        float& min, float& max)
+{
+    minMaxSpan<float>(data, std::min<std::size_t>(size, 4), min, max);
+    __m128 minimum = _mm_set1_ps(min);
+    __m128 maximum = _mm_set1_ps(max);
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        __m128 value = _mm_loadu_ps(data + i);
+        minimum = _mm_min_ps(minimum, value);
+        maximum = _mm_max_ps(maximum, value);
+    }
+    alignas(16) float minLanes[4];
+    alignas(16) float maxLanes[4];
+    _mm_store_ps(minLanes, minimum);
+    _mm_store_ps(maxLanes, maximum);
+    for (int lane = 0; lane < 4; ++lane) {
+        min = std::min(min, minLanes[lane]);
+        max = std::max(max, maxLanes[lane]);
+    }
+    for (; i < size; ++i) {
+        min = std::min(min, data[i]);
+        max = std::max(max, data[i]);
+    }
+}
+
+UTIL_SSE2 std::size_t countSse2(const std::int32_t* data, std::size_t size,
+        Comparison comparison, std::int32_t value)
+{
+    __m128i x = _mm_set1_epi32(value);
+    std::size_t result = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        result += __builtin_popcount(
+                compareSse2(loadSse2(data + i), x, comparison));
+    }
+    return result + countSpan<std::int32_t>(data + i, size - i, comparison,
+            value);
+}
+
+UTIL_SSE2 std::size_t countSse2(const float* data, std::size_t size,
+        Comparison comparison, float value)
+{
+    __m128 x = _mm_set1_ps(value);
+    std::size_t result = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        result += __builtin_popcount(
+                compareSse2(_mm_loadu_ps(data + i), x, comparison));
+    }
+    return result + countSpan<float>(data + i, size - i, comparison, value);
+}
+
+UTIL_SSE2 void maskSse2(const std::int32_t* data, std::size_t size,
+        Comparison comparison, std::int32_t value, Word* words)
+{
+    __m128i x = _mm_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        words[i / 64] |= static_cast<Word>(
+                compareSse2(loadSse2(data + i), x, comparison)) << (i % 64);
+    }
+    withComparison(comparison, value, [&](auto predicate) {
+                for (; i < size; ++i) {
+                    words[i / 64] |= static_cast<Word>(
+                            predicate(data[i]) ? 1 : 0) << (i % 64);
+                }
+            });
+}
+
+UTIL_SSE2 void maskSse2(const float* data, std::size_t size,
+        Comparison comparison, float value, Word* words)
+{
+    __m128 x = _mm_set1_ps(value);
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        words[i / 64] |= static_cast<Word>(
+                compareSse2(_mm_loadu_ps(data + i), x, comparison))
+                << (i % 64);
+    }
+    withComparison(comparison, value, [&](auto predicate) {
+                for (; i < size; ++i) {
+                    words[i / 64] |= static_cast<Word>(
+                            predicate(data[i]) ? 1 : 0) << (i % 64);
+                }
+            });
+}
+
+UTIL_SSE2 void clampSse2(std::int32_t* data, std::size_t size,
+        std::int32_t low, std::int32_t high)
+{
+    __m128i lowValue = _mm_set1_epi32(low);
+    __m128i highValue = _mm_set1_epi32(high);
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        storeSse2(data + i, minSse2(maxSse2(loadSse2(data + i), lowValue),
+                highValue));
+    }
+    clampSpan<std::int32_t>(data + i, size - i, low, high);
+}
+
+UTIL_SSE2 void clampSse2(float* data, std::size_t size, float low, float high)
+{
+    __m128 lowValue = _mm_set1_ps(low);
+    __m128 highValue = _mm_set1_ps(high);
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        _mm_storeu_ps(data + i, _mm_min_ps(
+                _mm_max_ps(_mm_loadu_ps(data + i), lowValue), highValue));
+    }
+    clampSpan<float>(data + i, size - i, low, high);
+}
+
+// ---------------------------------------------------------------- AVX2
+
+UTIL_AVX2 inline __m256i loadAvx2(const std::int32_t* data)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+}
+
+UTIL_AVX2 inline void storeAvx2(std::int32_t* data, __m256i value)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), value);
+}
+
+UTIL_AVX2 inline int compareAvx2(__m256i v, __m256i x, Comparison comparison)
+{
+    __m256i result;
+    bool invert = false;
+    switch (comparison) {
+    case Comparison::less: result = _mm256_cmpgt_epi32(x, v); break;
+    case Comparison::greaterEqual:
+        result = _mm256_cmpgt_epi32(x, v); invert = true; break;
+    case Comparison::greater: result = _mm256_cmpgt_epi32(v, x); break;
+    case Comparison::lessEqual:
+        result = _mm256_cmpgt_epi32(v, x); invert = true; break;
+    case Comparison::equal: result = _mm256_cmpeq_epi32(v, x); break;
+    default: result = _mm256_cmpeq_epi32(v, x); invert = true; break;
+    }
+    int bits = _mm256_movemask_ps(_mm256_castsi256_ps(result));
+    return invert ? bits ^ 0xFF : bits;
+}
+
+UTIL_AVX2 inline int compareAvx2(__m256 v, __m256 x, Comparison comparison)
+{
+    __m256 result;
+    switch (comparison) {
+    case Comparison::less: result = _mm256_cmp_ps(v, x, _CMP_LT_OQ); break;
+    case Comparison::lessEqual:
+        result = _mm256_cmp_ps(v, x, _CMP_LE_OQ); break;
+    case Comparison::equal: result = _mm256_cmp_ps(v, x, _CMP_EQ_OQ); break;
+    case Comparison::notEqual:
+        result = _mm256_cmp_ps(v, x, _CMP_NEQ_UQ); break;
+    case Comparison::greaterEqual:
+        result = _mm256_cmp_ps(v, x, _CMP_GE_OQ); break;
+    default: result = _mm256_cmp_ps(v, x, _CMP_GT_OQ); break;
+    }
+    return _mm256_movemask_ps(result);
+}
+
+UTIL_AVX2 std::int64_t sumAvx2(const std::int32_t* data, std::size_t size)
+{
+    __m256i accumulator = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i value = loadAvx2(data + i);
+        __m256i sign = _mm256_srai_epi32(value, 31);
+        accumulator = _mm256_add_epi64(accumulator,
+                _mm256_unpacklo_epi32(value, sign));
+        accumulator = _mm256_add_epi64(accumulator,
+                _mm256_unpackhi_epi32(value, sign));
+    }
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+            sumSpan<std::int32_t>(data + i, size - i);
+}
+
+UTIL_AVX2 double sumAvx2(const float* data, std::size_t size)
+{
+    __m256d accumulator1 = _mm256_setzero_pd();
+    __m256d accumulator2 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        accumulator1 = _mm256_add_pd(accumulator1,
+                _mm256_cvtps_pd(_mm_loadu_ps(data + i)));
+        accumulator2 = _mm256_add_pd(accumulator2,
+                _mm256_cvtps_pd(_mm_loadu_ps(data + i + 4)));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(accumulator1, accumulator2));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+            sumSpan<float>(data + i, size - i);
+}
+
+UTIL_AVX2 void minMaxAvx2(const std::int32_t* data, std::size_t size,
+        std::int32_t& min, std::int32_t& max)
+{
+    minMaxSpan<std::int32_t>(data, std::min<std::size_t>(size, 8), min, max);
+    __m256i minimum = _mm256_set1_epi32(min);
+    __m256i maximum = _mm256_set1_epi32(max);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256i value = loadAvx2(data + i);
+        minimum = _mm256_min_epi32(minimum, value);
+        maximum = _mm256_max_epi32(maximum, value);
+    }
+    alignas(32) std::int32_t minLanes[8];
+    alignas(32) std::int32_t maxLanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(minLanes), minimum);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(maxLanes), maximum);
+    for (int lane = 0; lane < 8; ++lane) {
+        min = std::min(min, minLanes[lane]);
+        max = std::max(max, maxLanes[lane]);
+    }
+    for (; i < size; ++i) {
+        min = std::min(min, data[i]);
+        max = std::max(max, data[i]);
+    }
+}
+
+UTIL_AVX2 void minMaxAvx2(const float* data, std::size_t size,
+        float& min, float& max)
+{
+    minMaxSpan<float>(data, std::min<std::size_t>(size, 8), min, max);
+    __m256 minimum = _mm256_set1_ps(min);
+    __m256 maximum = _mm256_set1_ps(max);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        __m256 value = _mm256_loadu_ps(data + i);
+        minimum = _mm256_min_ps(minimum, value);
+        maximum = _mm256_max_ps(maximum, value);
+    }
+    alignas(32) float minLanes[8];
+    alignas(32) float maxLanes[8];
+    _mm256_store_ps(minLanes, minimum);
+    _mm256_store_ps(maxLanes, maximum);
+    for (int lane = 0; lane < 8; ++lane) {
+        min = std::min(min, minLanes[lane]);
+        max = std::max(max, maxLanes[lane]);
+    }
+    for (; i < size; ++i) {
+        min = std::min(min, data[i]);
+        max = std::max(max, data[i]);
+    }
+}
+
+UTIL_AVX2 std::size_t countAvx2(const std::int32_t* data, std::size_t size,
+        Comparison comparison, std::int32_t value)
+{
+    __m256i x = _mm256_set1_epi32(value);
+    std::size_t result = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        result += __builtin_popcount(
+                compareAvx2(loadAvx2(data + i), x, comparison));
+    }
+    return result + countSpan<std::int32_t>(data + i, size - i, comparison,
+            value);
+}
+
+UTIL_AVX2 std::size_t countAvx2(const float* data, std::size_t size,
+        Comparison comparison, float value)
+{
+    __m256 x = _mm256_set1_ps(value);
+    std::size_t result = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        result += __builtin_popcount(
+                compareAvx2(_mm256_loadu_ps(data + i), x, comparison));
+    }
+    return result + countSpan<float>(data + i, size - i, comparison, value);
+}
+
+UTIL_AVX2 void maskAvx2(const std::int32_t* data, std::size_t size,
+        Comparison comparison, std::int32_t value, Word* words)
+{
+    __m256i x = _mm256_set1_epi32(value);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        words[i / 64] |= static_cast<Word>(
+                compareAvx2(loadAvx2(data + i), x, comparison)) << (i % 64);
+    }
+    withComparison(comparison, value, [&](auto predicate) {
+                for (; i < size; ++i) {
+                    words[i / 64] |= static_cast<Word>(
+                            predicate(data[i]) ? 1 : 0) << (i % 64);
+                }
+            });
+}
+
+UTIL_AVX2 void maskAvx2(const float* data, std::size_t size,
+        Comparison comparison, float value, Word* words)
+{
+    __m256 x = _mm256_set1_ps(value);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        words[i / 64] |= static_cast<Word>(
+                compareAvx2(_mm256_loadu_ps(data + i), x, comparison))
+                << (i % 64);
+    }
+    withComparison(comparison, value, [&](auto predicate) {
+                for (; i < size; ++i) {
+                    words[i / 64] |= static_cast<Word>(
+                            predicate(data[i]) ? 1 : 0) << (i % 64);
+                }
+            });
+}
+
+UTIL_AVX2 void clampAvx2(std::int32_t* data, std::size_t size,
+        std::int32_t low, std::int32_t high)
+{
+    __m256i lowValue = _mm256_set1_epi32(low);
+    __m256i highValue = _mm256_set1_epi32(high);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        storeAvx2(data + i, _mm256_min_epi32(
+                _mm256_max_epi32(loadAvx2(data + i), lowValue), highValue));
+    }
+    clampSpan<std::int32_t>(data + i, size - i, low, high);
+}
+
+UTIL_AVX2 void clampAvx2(float* data, std::size_t size, float low, float high)
+{
+    __m256 lowValue = _mm256_set1_ps(low);
+    __m256 highValue = _mm256_set1_ps(high);
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        _mm256_storeu_ps(data + i, _mm256_min_ps(
+                _mm256_max_ps(_mm256_loadu_ps(data + i), lowValue),
+                highValue));
+    }
+    clampSpan<float>(data + i, size - i, low, high);
+}
+
+#undef UTIL_SSE2
+#undef UTIL_AVX2
+
+} // unnamed namespace
+
+#define UTIL_DISPATCH(function, scalarFunction, ...) \
+    switch (getSimdLevel()) { \
+    case SimdLevel::avx2: return function##Avx2(__VA_ARGS__); \
+    case SimdLevel::sse2: return function##Sse2(__VA_ARGS__); \
+    default: return scalarFunction(__VA_ARGS__); \
+    }
+
+#else
+
+#define UTIL_DISPATCH(function, scalarFunction, ...) \
+    return scalarFunction(__VA_ARGS__);
+
+#endif // UTIL_MATRIX_KERNELS_X86
+
+std::int64_t sumSpan(const std::int32_t* data, std::size_t size)
+{
+    UTIL_DISPATCH(sum, sumSpan<std::int32_t>, data, size);
+}
+
+double sumSpan(const float* data, std::size_t size)
+{
+    UTIL_DISPATCH(sum, sumSpan<float>, data, size);
+}
+
+void minMaxSpan(const std::int32_t* data, std::size_t size,
+        std::int32_t& min, std::int32_t& max)
+{
+    UTIL_DISPATCH(minMax, minMaxSpan<std::int32_t>, data, size, min, max);
+}
+
+void minMaxSpan(const float* data, std::size_t size, float& min, float& max)
+{
+    UTIL_DISPATCH(minMax, minMaxSpan<float>, data, size, min, max);
+}
+
+std::size_t countSpan(const std::int32_t* data, std::size_t size,
+        Comparison comparison, std::int32_t value)
+{
+    UTIL_DISPATCH(count, countSpan<std::int32_t>, data, size, comparison,
+            value);
+}
+
+std::size_t countSpan(const float* data, std::size_t size,
+        Comparison comparison, float value)
+{
+    UTIL_DISPATCH(count, countSpan<float>, data, size, comparison, value);
+}
+
+void maskSpan(const std::int32_t* data, std::size_t size,
+        Comparison comparison, std::int32_t value, Word* words)
+{
+    UTIL_DISPATCH(mask, maskSpan<std::int32_t>, data, size, comparison, value,
+            words);
+}
+
+void maskSpan(const float* data, std::size_t size,
+        Comparison comparison, float value, Word* words)
+{
+    UTIL_DISPATCH(mask, maskSpan<float>, data, size, comparison, value,
+            words);
+}
+
+void clampSpan(std::int32_t* data, std::size_t size,
+        std::int32_t low, std::int32_t high)
+{
+    UTIL_DISPATCH(clamp, clampSpan<std::int32_t>, data, size, low, high);
+}
+
+void clampSpan(float* data, std::size_t size, float low, float high)
+{
+    UTIL_DISPATCH(clamp, clampSpan<float>, data, size, low, high);
+}
+
+#undef UTIL_DISPATCH
+
+} // namespace detail
+
+} // namespace kernels
+} // namespace matrix
+} // namespace util
@@ -0,0 +1,116 @@
+#include "matrix/AlignedMatrix.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(AlignedMatrixTest)
+
+BOOST_AUTO_TEST_CASE(DefaultConstruct) {
+    AlignedMatrix<int> matrix{};
+    BOOST_TEST(matrix.width() == 0);
+    BOOST_TEST(matrix.height() == 0);
+    BOOST_CHECK(matrix.begin() == matrix.end());
+}
+
+BOOST_AUTO_TEST_CASE(RowsAreAligned) {
+    AlignedMatrix<char> matrix{5, 4};
+    BOOST_TEST(matrix.width() == 5);
+    BOOST_TEST(matrix.height() == 4);
+    BOOST_TEST(matrix.stride() == 64);
+    for (std::size_t y = 0; y < matrix.height(); ++y) {
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(matrix.row(y)) % 64 == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(StrideOfOddSizedElements) {
+    struct Element { char data[3]; };
+    AlignedMatrix<Element> matrix{2, 3};
+    BOOST_TEST(matrix.stride() * sizeof(Element) % 64 == 0);
+    BOOST_TEST(reinterpret_cast<std::uintptr_t>(matrix.row(2)) % 64 == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ConstructWithDefaultValue) {
+    const int value = 423;
+    AlignedMatrix<int> matrix{3, 2, value};
+    for (Point p : matrixRange(matrix)) {
+        BOOST_CHECK_EQUAL(matrix[p], value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ConstructFromInitializerList) {
+    AlignedMatrix<int> matrix{3, 2, {1, 5, 3, 0, 2, 7}};
+    BOOST_CHECK_EQUAL((matrix[Point{0, 0}]), 1);
+    BOOST_CHECK_EQUAL((matrix[Point{1, 0}]), 5);
+    BOOST_CHECK_EQUAL((matrix[Point{2, 0}]), 3);
+    BOOST_CHECK_EQUAL((matrix[Point{0, 1}]), 0);
+    BOOST_CHECK_EQUAL((matrix[Point{1, 1}]), 2);
+    BOOST_CHECK_EQUAL((matrix[Point{2, 1}]), 7);
+    BOOST_CHECK_EQUAL(matrix.row(1)[2], 7);
+}
+
+BOOST_AUTO_TEST_CASE(ConstructFromMatrix) {
+    Matrix<int> matrix{3, 2, {1, 2, 3, 4, 5, 6}};
+    AlignedMatrix<int> aligned{matrix};
+    BOOST_CHECK_EQUAL_COLLECTIONS(aligned.begin(), aligned.end(),
+            matrix.begin(), matrix.end());
+    for (Point p : matrixRange(matrix)) {
+        BOOST_CHECK_EQUAL(aligned[p], matrix[p]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(IterateSkipsPadding) {
+    AlignedMatrix<int> matrix{3, 3, -1};
+    int i = 0;
+    for (int& value : matrix) {
+        value = i++;
+    }
+    BOOST_TEST(i == 9);
+    BOOST_CHECK_EQUAL((matrix[Point{0, 1}]), 3);
+    BOOST_CHECK_EQUAL((matrix[Point{2, 2}]), 8);
+    BOOST_CHECK_EQUAL(matrix.row(1)[matrix.width()], -1);
+
+    auto it = matrix.end();
+    for (int expected = 8; expected >= 0; --expected) {
+        BOOST_CHECK_EQUAL(*--it, expected);
+    }
+    BOOST_CHECK(it == matrix.begin());
+}
+
+BOOST_AUTO_TEST_CASE(ZeroWidth) {
+    AlignedMatrix<int> matrix{0, 3};
+    BOOST_CHECK(matrix.begin() == matrix.end());
+}
+
+BOOST_AUTO_TEST_CASE(ResetAndFill) {
+    AlignedMatrix<int> matrix{2, 3};
+    matrix.reset(20, 2, 7);
+    BOOST_TEST(matrix.width() == 20);
+    BOOST_TEST(matrix.height() == 2);
+    BOOST_TEST(matrix.stride() == 32);
+    BOOST_CHECK_EQUAL((matrix[Point{19, 1}]), 7);
+    matrix.fill(3);
+    BOOST_CHECK_EQUAL((matrix[Point{5, 0}]), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Compare) {
+    AlignedMatrix<int> matrix1{2, 2, {1, 2, 3, 4}};
+    AlignedMatrix<int> matrix2{2, 2, {1, 2, 3, 4}};
+    AlignedMatrix<int> matrix3{2, 2, {1, 2, 3, 5}};
+    matrix2.row(0)[2] = 100;
+    BOOST_CHECK(matrix1 == matrix2);
+    BOOST_CHECK(matrix1 != matrix3);
+}
+
+BOOST_AUTO_TEST_CASE(Move) {
+    AlignedMatrix<int> matrix1{2, 3, 5};
+    auto matrix2 = std::move(matrix1);
+    BOOST_TEST(matrix1.width() == 0);
+    BOOST_TEST(matrix1.height() == 0);
+    BOOST_TEST(matrix2.width() == 2);
+    BOOST_CHECK_EQUAL((matrix2[Point{1, 2}]), 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // AlignedMatrixTest
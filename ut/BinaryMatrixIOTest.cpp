@@ -0,0 +1,155 @@
+#include "matrix/BinaryMatrixIO.hpp"
+#include "matrix/MatrixIO.hpp"
+#include "matrix/MatrixView.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <sstream>
+
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+namespace {
+
+template<typename T>
+std::string saveToString(const T& value) {
+    std::ostringstream ss;
+    boost::archive::binary_oarchive ar{ss, boost::archive::no_header};
+    ar << value;
+    return ss.str();
+}
+
+template<typename T>
+T loadFromString(const std::string& data) {
+    std::istringstream ss{data};
+    boost::archive::binary_iarchive ar{ss, boost::archive::no_header};
+    T result;
+    ar >> result;
+    return result;
+}
+
+// Rewrites a saved file as if it had been written on a machine with the
+// other byte order.
+void swapByteOrder(std::string& data, std::size_t componentSize) {
+    MatrixFileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    detail::byteSwapElements(&header.byteOrder, 1);
+    detail::byteSwapElements(&header.version, 1);
+    detail::byteSwapElements(&header.elementSize, 1);
+    detail::byteSwapElements(&header.width, 1);
+    detail::byteSwapElements(&header.height, 1);
+    std::memcpy(&data[0], &header, sizeof(header));
+    for (std::size_t i = sizeof(header); i < data.size();
+            i += componentSize) {
+        std::reverse(&data[i], &data[i] + componentSize);
+    }
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(BinaryMatrixIOTest)
+
+BOOST_AUTO_TEST_CASE(SaveAndLoad) {
+    Matrix<std::int16_t> matrix = createMatrix<std::int16_t>(7, 5);
+    std::stringstream ss;
+    saveMatrixBinary(ss, matrix);
+    BOOST_TEST(ss.str().size() == sizeof(MatrixFileHeader) + 7 * 5 * 2);
+    BOOST_CHECK_EQUAL(loadMatrixBinary<std::int16_t>(ss), matrix);
+}
+
+BOOST_AUTO_TEST_CASE(SaveView) {
+    Matrix<int> matrix = createMatrix<int>(6, 6);
+    std::stringstream ss;
+    saveMatrixBinary(ss, matrixView(matrix, p11, 3, 4));
+    Matrix<int> loaded = loadMatrixBinary<int>(ss);
+    BOOST_TEST(loaded.width() == 3);
+    BOOST_TEST(loaded.height() == 4);
+    for (Point p : matrixRange(loaded)) {
+        BOOST_TEST_REQUIRE(loaded[p] == matrix[p + p11]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Points) {
+    std::vector<Point> points{Point{1, 2}, Point{-3, 4}, Point{5, -600000}};
+    std::stringstream ss;
+    saveVectorBinary(ss, points);
+    std::vector<Point> loaded = loadVectorBinary<Point>(ss);
+    BOOST_CHECK_EQUAL_COLLECTIONS(loaded.begin(), loaded.end(),
+            points.begin(), points.end());
+}
+
+BOOST_AUTO_TEST_CASE(ForeignByteOrder) {
+    Matrix<double> matrix = createMatrix<double>(3, 4);
+    std::stringstream ss;
+    saveMatrixBinary(ss, matrix);
+    std::string data = ss.str();
+    swapByteOrder(data, sizeof(double));
+    std::istringstream is{data};
+    BOOST_CHECK_EQUAL(loadMatrixBinary<double>(is), matrix);
+
+    std::vector<Point> points{Point{1, 2}, Point{-3, 4}};
+    std::stringstream pointStream;
+    saveVectorBinary(pointStream, points);
+    data = pointStream.str();
+    swapByteOrder(data, sizeof(int));
+    std::istringstream pointInput{data};
+    std::vector<Point> loaded = loadVectorBinary<Point>(pointInput);
+    BOOST_CHECK_EQUAL_COLLECTIONS(loaded.begin(), loaded.end(),
+            points.begin(), points.end());
+}
+
+BOOST_AUTO_TEST_CASE(ForeignByteOrderOfUnknownType) {
+    struct Pair { short a, b; };
+    std::vector<Pair> values(3);
+    std::stringstream ss;
+    saveVectorBinary(ss, values);
+    std::string data = ss.str();
+    swapByteOrder(data, sizeof(Pair));
+    std::istringstream is{data};
+    BOOST_CHECK_THROW(loadVectorBinary<Pair>(is), MatrixFileError);
+}
+
+BOOST_AUTO_TEST_CASE(Errors) {
+    std::stringstream ss;
+    saveMatrixBinary(ss, createMatrix<int>(4, 4));
+    std::string data = ss.str();
+
+    std::istringstream wrongType{data};
+    BOOST_CHECK_THROW(loadMatrixBinary<double>(wrongType), MatrixFileError);
+
+    std::istringstream truncated{data.substr(0, data.size() - 1)};
+    BOOST_CHECK_THROW(loadMatrixBinary<int>(truncated), MatrixFileError);
+
+    std::istringstream garbage{std::string(100, 'x')};
+    BOOST_CHECK_THROW(loadMatrixBinary<int>(garbage), MatrixFileError);
+
+    // 2^33 * 2^33 * 4 wraps around to 0.
+    MatrixFileHeader header = makeMatrixFileHeader(sizeof(int),
+            std::uint64_t{1} << 33, std::uint64_t{1} << 33);
+    std::string hugeData(reinterpret_cast<const char*>(&header),
+            sizeof(header));
+    std::istringstream hugeMatrix{hugeData};
+    BOOST_CHECK_THROW(loadMatrixBinary<int>(hugeMatrix), MatrixFileError);
+    std::istringstream hugeVector{hugeData};
+    BOOST_CHECK_THROW(loadVectorBinary<int>(hugeVector), MatrixFileError);
+}
+
+// Boost archives keep their own encoding, so archives written earlier still
+// load.
+BOOST_AUTO_TEST_CASE(BinaryArchiveOfPoints) {
+    std::vector<Point> points{Point{1, 2}, Point{-3, 4}};
+    auto loaded = loadFromString<std::vector<Point>>(saveToString(points));
+    BOOST_CHECK_EQUAL_COLLECTIONS(loaded.begin(), loaded.end(),
+            points.begin(), points.end());
+
+    Matrix<Point> matrix{3, 2, Point{3, 4}};
+    BOOST_CHECK(loadFromString<Matrix<Point>>(saveToString(matrix)) ==
+            matrix);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // BinaryMatrixIOTest
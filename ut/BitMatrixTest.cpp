@@ -0,0 +1,144 @@
+#include "matrix/BitMatrix.hpp"
+
+#include <boost/optional/optional_io.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(BitMatrixTest)
+
+namespace {
+
+BitMatrix createMatrix(std::size_t width, std::size_t height,
+        const std::vector<Point>& points) {
+    BitMatrix result{width, height};
+    for (Point p : points) {
+        result.set(p);
+    }
+    return result;
+}
+
+std::vector<Point> setPoints(const BitMatrix& matrix) {
+    std::vector<Point> result;
+    matrix.forEachSet([&result](Point p) { result.push_back(p); });
+    return result;
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_CASE(Construct) {
+    BitMatrix matrix{70, 3};
+    BOOST_TEST(matrix.width() == 70);
+    BOOST_TEST(matrix.height() == 3);
+    BOOST_TEST(matrix.wordsPerRow() == 2);
+    BOOST_TEST(matrix.count() == 0);
+
+    BitMatrix filled{70, 3, true};
+    BOOST_TEST(filled.count() == 210);
+    BOOST_TEST(filled.countRow(1) == 70);
+}
+
+BOOST_AUTO_TEST_CASE(SetAndGet) {
+    BitMatrix matrix{100, 2};
+    matrix[Point{0, 0}] = true;
+    matrix[Point{64, 0}] = true;
+    matrix.set(Point{99, 1});
+    BOOST_TEST((matrix[Point{0, 0}]));
+    BOOST_TEST((matrix[Point{64, 0}]));
+    BOOST_TEST((matrix[Point{99, 1}]));
+    BOOST_TEST(!(matrix[Point{63, 0}]));
+    BOOST_TEST(!(matrix[Point{99, 0}]));
+    BOOST_TEST(matrix.count() == 3);
+
+    matrix[Point{64, 0}] = false;
+    BOOST_TEST(!(matrix[Point{64, 0}]));
+    matrix[Point{1, 1}] = matrix[Point{0, 0}];
+    BOOST_TEST((matrix[Point{1, 1}]));
+    BOOST_TEST((matrixAt(matrix, Point{1, 1}, false)));
+    BOOST_TEST(!(matrixAt(matrix, Point{1, 2}, false)));
+}
+
+BOOST_AUTO_TEST_CASE(RowWords) {
+    BitMatrix matrix = createMatrix(80, 2, {Point{1, 1}, Point{65, 1}});
+    BOOST_TEST(matrix.rowWords(1)[0] == 2u);
+    BOOST_TEST(matrix.rowWords(1)[1] == 2u);
+    BOOST_TEST(matrix.rowWords(0)[1] == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(BitwiseOperations) {
+    BitMatrix a = createMatrix(3, 2, {Point{0, 0}, Point{1, 0}, Point{2, 1}});
+    BitMatrix b = createMatrix(3, 2, {Point{1, 0}, Point{2, 1}, Point{0, 1}});
+    BOOST_CHECK((a & b) == createMatrix(3, 2, {Point{1, 0}, Point{2, 1}}));
+    BOOST_CHECK((a | b) == createMatrix(3, 2,
+            {Point{0, 0}, Point{1, 0}, Point{2, 1}, Point{0, 1}}));
+    BOOST_CHECK((a ^ b) == createMatrix(3, 2, {Point{0, 0}, Point{0, 1}}));
+    BOOST_CHECK(~a == createMatrix(3, 2, {Point{2, 0}, Point{0, 1},
+            Point{1, 1}}));
+    BOOST_CHECK(BitMatrix{a}.subtract(b) == createMatrix(3, 2, {Point{0, 0}}));
+    BOOST_TEST((~a).count() == 3);
+}
+
+BOOST_AUTO_TEST_CASE(FillAndReset) {
+    BitMatrix matrix{10, 10};
+    matrix.fill(true);
+    BOOST_TEST(matrix.count() == 100);
+    matrix.reset(130, 2, true);
+    BOOST_TEST(matrix.count() == 260);
+    matrix.fill(false);
+    BOOST_TEST(matrix.count() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(FindNext) {
+    BitMatrix matrix = createMatrix(100, 3,
+            {Point{5, 0}, Point{70, 0}, Point{99, 2}});
+    BOOST_CHECK_EQUAL(matrix.findNext(p00), boost::make_optional(Point{5, 0}));
+    BOOST_CHECK_EQUAL(matrix.findNext(Point{5, 0}),
+            boost::make_optional(Point{5, 0}));
+    BOOST_CHECK_EQUAL(matrix.findNext(Point{6, 0}),
+            boost::make_optional(Point{70, 0}));
+    BOOST_CHECK_EQUAL(matrix.findNext(Point{71, 0}),
+            boost::make_optional(Point{99, 2}));
+    BOOST_CHECK_EQUAL(matrix.findNext(Point{100, 2}), boost::none);
+    BOOST_CHECK_EQUAL(BitMatrix{}.findNext(p00), boost::none);
+}
+
+BOOST_AUTO_TEST_CASE(ForEachSet) {
+    std::vector<Point> points{Point{5, 0}, Point{70, 0}, Point{0, 1},
+            Point{99, 2}};
+    BitMatrix matrix = createMatrix(100, 3, points);
+    std::vector<Point> result = setPoints(matrix);
+    BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(),
+            points.begin(), points.end());
+}
+
+BOOST_AUTO_TEST_CASE(Shift) {
+    const std::size_t width = 150;
+    const std::size_t height = 5;
+    std::vector<Point> points{Point{0, 0}, Point{63, 1}, Point{64, 2},
+            Point{100, 3}, Point{149, 4}, Point{70, 0}};
+    BitMatrix matrix = createMatrix(width, height, points);
+    for (Point offset : {Point{0, 0}, Point{1, 0}, Point{-1, 0},
+            Point{64, 1}, Point{-65, -2}, Point{30, 3}, Point{-149, 0},
+            Point{150, 0}}) {
+        BitMatrix expected{width, height};
+        for (Point p : points) {
+            if (isInsideMatrix(expected, p + offset)) {
+                expected.set(p + offset);
+            }
+        }
+        BOOST_CHECK_MESSAGE(matrix.shifted(offset) == expected,
+                "offset " << offset);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ConvertMatrix) {
+    Matrix<bool> matrix{3, 2, {true, false, false, false, true, true}};
+    BitMatrix bits{matrix};
+    BOOST_TEST(bits.count() == 3);
+    BOOST_TEST((bits[Point{1, 1}]));
+    BOOST_CHECK(bits.toMatrix() == matrix);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // BitMatrixTest
@@ -0,0 +1,141 @@
+#include "matrix/BitMatrix.hpp"
+#include "matrix/DistanceTransform.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <limits>
+
+using namespace util;
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+namespace {
+
+Matrix<bool> createFeatures(std::size_t width, std::size_t height,
+        unsigned seed, unsigned percent) {
+    return createRandomMatrix<bool>(width, height, seed,
+            [percent](unsigned value) { return value % 100 < percent; });
+}
+
+template<typename Result, typename Distance>
+Matrix<Result> transformNaively(const Matrix<bool>& features,
+        Distance distance) {
+    Matrix<Result> result{features.width(), features.height(),
+            std::numeric_limits<Result>::max()};
+    for (Point p : matrixRange(features)) {
+        for (Point q : matrixRange(features)) {
+            if (features[q]) {
+                result[p] = std::min<Result>(result[p], distance(p, q));
+            }
+        }
+    }
+    return result;
+}
+
+const std::vector<Point> sizes{Point{1, 1}, Point{1, 7}, Point{9, 1},
+        Point{13, 11}, Point{70, 5}};
+
+// Runs function(features) for maps of several sizes and densities, including
+// ones without any feature cells.
+template<typename Function>
+void forEachMap(Function function) {
+    for (Point size : sizes) {
+        for (unsigned percent : {0u, 1u, 5u, 30u, 100u}) {
+            for (unsigned seed = 0; seed < 2; ++seed) {
+                BOOST_TEST_CONTEXT("size " << size << " percent " << percent
+                        << " seed " << seed) {
+                    function(createFeatures(size.x, size.y, seed, percent));
+                }
+            }
+        }
+    }
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(DistanceTransformTest)
+
+BOOST_AUTO_TEST_CASE(Manhattan) {
+    forEachMap([](const Matrix<bool>& features) {
+            auto expected = transformNaively<int>(features,
+                    [](Point p, Point q) { return distance(p, q); });
+            BOOST_TEST(manhattanDistanceTransform(features) == expected);
+            BOOST_TEST(manhattanDistanceTransform(BitMatrix{features}) ==
+                    expected);
+        });
+}
+
+BOOST_AUTO_TEST_CASE(Chebyshev) {
+    forEachMap([](const Matrix<bool>& features) {
+            auto expected = transformNaively<int>(features,
+                    [](Point p, Point q) { return chebyshevDistance(p, q); });
+            BOOST_TEST(chebyshevDistanceTransform(features) == expected);
+        });
+}
+
+BOOST_AUTO_TEST_CASE(EuclideanSquare) {
+    forEachMap([](const Matrix<bool>& features) {
+            auto expected = transformNaively<long>(features,
+                    [](Point p, Point q) { return distanceSquare(p, q); });
+            BOOST_TEST(euclideanSquareDistanceTransform(features) ==
+                    expected);
+        });
+}
+
+BOOST_AUTO_TEST_CASE(Euclidean) {
+    Matrix<bool> features{5, 4, false};
+    features[Point{1, 1}] = true;
+    features[Point{4, 3}] = true;
+    Matrix<float> result = euclideanDistanceTransform(features);
+    for (Point p : matrixRange(features)) {
+        float expected = std::sqrt(static_cast<float>(std::min(
+                distanceSquare(p, Point{1, 1}),
+                distanceSquare(p, Point{4, 3}))));
+        BOOST_TEST(result[p] == expected);
+    }
+
+    Matrix<float> empty = euclideanDistanceTransform(
+            Matrix<bool>{3, 3, false});
+    BOOST_TEST((empty[p11]) == std::numeric_limits<float>::max());
+}
+
+BOOST_AUTO_TEST_CASE(Hex) {
+    forEachMap([](const Matrix<bool>& features) {
+            auto expected = transformNaively<int>(features,
+                    [](Point p, Point q) { return hex::distance(p, q); });
+            BOOST_TEST(hexDistanceTransform(features) == expected);
+        });
+}
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+    ThreadPool threadPool{4};
+    ThreadPoolRunner runner{threadPool};
+    Matrix<bool> features = createFeatures(37, 29, 3, 2);
+    auto manhattan = manhattanDistanceTransform(features);
+    auto chebyshev = chebyshevDistanceTransform(features);
+    auto euclideanSquare = euclideanSquareDistanceTransform(features);
+    auto euclidean = euclideanDistanceTransform<double>(features);
+    for (std::size_t grain : {0, 1, 4, 100}) {
+        BOOST_TEST_CONTEXT("grain " << grain) {
+            BOOST_TEST(manhattanDistanceTransform(threadPool, features,
+                    grain) == manhattan);
+            BOOST_TEST(chebyshevDistanceTransform(threadPool, features,
+                    grain) == chebyshev);
+            BOOST_TEST(euclideanSquareDistanceTransform(threadPool, features,
+                    grain) == euclideanSquare);
+            BOOST_TEST(euclideanDistanceTransform<double>(threadPool,
+                    features, grain) == euclidean);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Empty) {
+    BOOST_TEST(manhattanDistanceTransform(Matrix<bool>{}).size() == 0u);
+    BOOST_TEST(euclideanDistanceTransform(Matrix<bool>{}).size() == 0u);
+    BOOST_TEST(hexDistanceTransform(Matrix<bool>{}).size() == 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // DistanceTransformTest
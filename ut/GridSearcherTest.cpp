@@ -0,0 +1,179 @@
+#include "matrix/GridSearcher.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+using namespace util::matrix;
+
+namespace {
+
+// '#' is a wall.
+Matrix<char> createMap() {
+    Matrix<char> result{7, 5};
+    const char* rows[] = {
+        ".......",
+        ".####..",
+        ".#..#..",
+        ".#..#..",
+        "....#..",
+    };
+    for (Point p : matrixRange(result)) {
+        result[p] = rows[p.y][p.x];
+    }
+    return result;
+}
+
+struct Passable {
+    const Matrix<char>& map;
+
+    bool operator()(Point p) const { return map[p] != '#'; }
+};
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(GridSearcherTest)
+
+BOOST_AUTO_TEST_CASE(Distances) {
+    Matrix<char> map = createMap();
+    GridSearcher<> searcher{map.width(), map.height()};
+    Matrix<int> distances{map.width(), map.height(), -1};
+    int lastDistance = 0;
+    searcher.bfs(p00, Passable{map}, [&](Point p, int distance) {
+            BOOST_TEST(distance >= lastDistance);
+            lastDistance = distance;
+            distances[p] = distance;
+            return true;
+        });
+    BOOST_TEST((distances[Point{0, 0}]) == 0);
+    BOOST_TEST((distances[Point{6, 0}]) == 6);
+    BOOST_TEST((distances[Point{0, 4}]) == 4);
+    BOOST_TEST((distances[Point{2, 2}]) == 8);
+    BOOST_TEST((distances[Point{3, 2}]) == 9);
+    BOOST_TEST((distances[Point{1, 1}]) == -1);
+    BOOST_TEST((distances[Point{6, 4}]) == 10);
+    BOOST_TEST(searcher.isVisited(Point{3, 3}));
+    BOOST_TEST(!searcher.isVisited(Point{4, 4}));
+}
+
+BOOST_AUTO_TEST_CASE(EarlyExit) {
+    Matrix<char> map = createMap();
+    GridSearcher<> searcher{map.width(), map.height()};
+    Point target{2, 3};
+    int found = -1;
+    int visitedCount = 0;
+    bool stopped = searcher.bfs(p00, Passable{map},
+            [&](Point p, int distance) {
+                ++visitedCount;
+                if (p == target) {
+                    found = distance;
+                    return false;
+                }
+                return true;
+            });
+    BOOST_TEST(stopped);
+    BOOST_TEST(found == 7);
+    BOOST_TEST(visitedCount < 25);
+
+    stopped = searcher.bfs(p00, Passable{map},
+            [](Point, int) { return true; });
+    BOOST_TEST(!stopped);
+}
+
+BOOST_AUTO_TEST_CASE(MaxDistance) {
+    Matrix<char> map = createMap();
+    GridSearcher<> searcher{map.width(), map.height()};
+    int maxSeen = 0;
+    int count = 0;
+    searcher.bfs(p00, Passable{map}, [&](Point, int distance) {
+            maxSeen = std::max(maxSeen, distance);
+            ++count;
+            return true;
+        }, 2);
+    BOOST_TEST(maxSeen == 2);
+    BOOST_TEST(count == 5);
+    BOOST_TEST(!searcher.isVisited(Point{3, 0}));
+    BOOST_TEST((searcher.visitedEnd() - searcher.visitedBegin()) == 5);
+}
+
+BOOST_AUTO_TEST_CASE(MultipleSources) {
+    Matrix<char> map = createMap();
+    GridSearcher<> searcher{map.width(), map.height()};
+    Matrix<int> distances{map.width(), map.height(), -1};
+    searcher.bfs(std::vector<Point>{p00, Point{6, 4}}, Passable{map},
+            [&](Point p, int distance) {
+                distances[p] = distance;
+                return true;
+            });
+    BOOST_TEST((distances[Point{6, 0}]) == 4);
+    BOOST_TEST((distances[Point{3, 0}]) == 3);
+    BOOST_TEST((distances[Point{3, 3}]) == 8);
+}
+
+BOOST_AUTO_TEST_CASE(FloodFill) {
+    Matrix<int> colors{6, 4, {
+            1, 1, 2, 2, 2, 2,
+            1, 2, 2, 1, 1, 2,
+            1, 1, 1, 1, 2, 2,
+            2, 2, 2, 1, 2, 1}};
+    GridSearcher<> searcher{colors.width(), colors.height()};
+    std::vector<Point> filled;
+    searcher.floodFill(p00, [&](Point p) { return colors[p] == 1; },
+            [&](Point p) { filled.push_back(p); });
+    BOOST_TEST(filled.size() == 10u);
+    BOOST_TEST(std::count(filled.begin(), filled.end(), Point{5, 3}) == 0);
+
+    GridSearcher<HexNeighborhood> hexSearcher{colors.width(),
+            colors.height()};
+    filled.clear();
+    hexSearcher.floodFill(Point{4, 3},
+            [&](Point p) { return colors[p] == 2; },
+            [&](Point p) { filled.push_back(p); });
+    // (5, 2) is reached through (4, 3); (5, 3) is also adjacent to it, but has
+    // the other color.
+    BOOST_TEST(filled.size() == 10u);
+    BOOST_TEST(std::count(filled.begin(), filled.end(), Point{5, 2}) == 1);
+    BOOST_TEST(std::count(filled.begin(), filled.end(), Point{5, 3}) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(HexNeighbors) {
+    GridSearcher<HexNeighborhood> searcher{6, 6};
+    auto neighbors = [&searcher](Point start) {
+        std::set<Point> result;
+        searcher.bfs(start, [](Point) { return true; },
+                [&](Point p, int distance) {
+                    if (distance == 1) {
+                        result.insert(p);
+                    }
+                    return true;
+                }, 1);
+        return result;
+    };
+    // Even columns are adjacent to the upper diagonal cells, odd columns to
+    // the lower ones.
+    BOOST_TEST((neighbors(Point{2, 2}) == std::set<Point>{Point{1, 2},
+            Point{1, 1}, Point{2, 1}, Point{3, 1}, Point{3, 2},
+            Point{2, 3}}));
+    BOOST_TEST((neighbors(Point{3, 2}) == std::set<Point>{Point{2, 3},
+            Point{2, 2}, Point{3, 1}, Point{4, 2}, Point{4, 3},
+            Point{3, 3}}));
+}
+
+BOOST_AUTO_TEST_CASE(ManySearchesReuseState) {
+    Matrix<char> map = createMap();
+    GridSearcher<SquareDiagonalNeighborhood> searcher{
+            map.width(), map.height()};
+    for (int i = 0; i < 1000; ++i) {
+        int count = 0;
+        searcher.bfs(Point{i % 7, 0}, Passable{map}, [&](Point, int) {
+                ++count;
+                return true;
+            });
+        BOOST_TEST_REQUIRE(count == 26);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // GridSearcherTest
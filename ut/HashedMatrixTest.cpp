@@ -0,0 +1,102 @@
+#include "matrix/HashedMatrix.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <unordered_set>
+
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+BOOST_AUTO_TEST_SUITE(HashedMatrixTest)
+
+BOOST_AUTO_TEST_CASE(ReadAndWrite) {
+    HashedMatrix<int> matrix{3, 2, 1};
+    BOOST_TEST(matrix.width() == 3);
+    BOOST_TEST(matrix.height() == 2);
+    matrix[Point{1, 1}] = 5;
+    matrix.set(Point{2, 0}, 7);
+    matrix[Point{0, 0}] += 2;
+    BOOST_TEST((matrix[Point{1, 1}]) == 5);
+    BOOST_TEST((matrix[Point{2, 0}]) == 7);
+    BOOST_TEST((matrix[Point{0, 0}]) == 3);
+    int value = matrix[Point{1, 1}];
+    BOOST_TEST(value == 5);
+    BOOST_CHECK(matrix.matrix() == (Matrix<int>{3, 2, {3, 1, 7, 1, 5, 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(ReadBoolThroughProxy) {
+    HashedMatrix<bool> matrix{3, 2, false};
+    matrix[Point{2, 1}] = true;
+    bool value = matrix[Point{2, 1}];
+    BOOST_TEST(value);
+    value = matrix[Point{1, 1}].get();
+    BOOST_TEST(!value);
+    matrix[Point{0, 0}] = matrix[Point{2, 1}];
+    BOOST_CHECK(matrix.matrix() ==
+            (Matrix<bool>{3, 2, {true, false, false, false, false, true}}));
+}
+
+BOOST_AUTO_TEST_CASE(HashFollowsWrites) {
+    HashedMatrix<int> matrix{createMatrix(5, 4)};
+    HashedMatrix<int> original = matrix;
+    matrix[Point{2, 3}] = 100;
+    BOOST_TEST(matrix.hash() != original.hash());
+    BOOST_TEST(matrix.hash() == HashedMatrix<int>{matrix.matrix()}.hash());
+    matrix[Point{2, 3}] = original[Point{2, 3}];
+    BOOST_TEST(matrix.hash() == original.hash());
+    BOOST_CHECK(matrix == original);
+}
+
+BOOST_AUTO_TEST_CASE(HashDoesNotDependOnOrderOfWrites) {
+    HashedMatrix<int> matrix1{4, 4, 0};
+    HashedMatrix<int> matrix2{4, 4, 0};
+    matrix1[Point{1, 2}] = 3;
+    matrix1[Point{3, 0}] = 4;
+    matrix2[Point{3, 0}] = 4;
+    matrix2[Point{1, 2}] = 7;
+    matrix2[Point{1, 2}] = 3;
+    BOOST_TEST(matrix1.hash() == matrix2.hash());
+    BOOST_CHECK(matrix1 == matrix2);
+}
+
+BOOST_AUTO_TEST_CASE(SwappedCellsDiffer) {
+    HashedMatrix<int> matrix1{2, 2, {0}};
+    HashedMatrix<int> matrix2{2, 2, {0}};
+    matrix1[Point{0, 0}] = 1;
+    matrix1[Point{1, 0}] = 2;
+    matrix2[Point{0, 0}] = 2;
+    matrix2[Point{1, 0}] = 1;
+    BOOST_TEST(matrix1.hash() != matrix2.hash());
+    BOOST_CHECK(matrix1 != matrix2);
+}
+
+BOOST_AUTO_TEST_CASE(DimensionsAreHashed) {
+    BOOST_TEST(HashedMatrix<int>(2, 3).hash() !=
+            HashedMatrix<int>(3, 2).hash());
+}
+
+BOOST_AUTO_TEST_CASE(BulkOperationsRehash) {
+    HashedMatrix<int> matrix{createMatrix(3, 3)};
+    matrix.fill(2);
+    BOOST_TEST(matrix.hash() == HashedMatrix<int>(3, 3, 2).hash());
+    matrix.reset(4, 2, 1);
+    BOOST_TEST(matrix.hash() == HashedMatrix<int>(4, 2, 1).hash());
+    matrix.clear();
+    BOOST_TEST(matrix.hash() == HashedMatrix<int>{}.hash());
+}
+
+BOOST_AUTO_TEST_CASE(UnorderedSet) {
+    std::unordered_set<HashedMatrix<std::string>> set;
+    HashedMatrix<std::string> matrix{2, 2, "x"};
+    set.insert(matrix);
+    matrix[Point{1, 1}] = "y";
+    set.insert(matrix);
+    matrix[Point{1, 1}] = "x";
+    BOOST_TEST(set.count(matrix) == 1);
+    BOOST_TEST(set.size() == 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // HashedMatrixTest
@@ -0,0 +1,126 @@
+#include "matrix/InfiniteGrid.hpp"
+#include "matrix/MatrixIO.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <climits>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(InfiniteGridTest)
+
+BOOST_AUTO_TEST_CASE(NegativeCoordinates) {
+    InfiniteGrid<int, 4> grid{-1};
+    grid[Point{-1, -1}] = 1;
+    grid[Point{-4, 0}] = 2;
+    grid[Point{-5, -9}] = 3;
+    grid[Point{3, 3}] = 4;
+    const auto& constGrid = grid;
+    BOOST_TEST((constGrid[Point{-1, -1}]) == 1);
+    BOOST_TEST((constGrid[Point{-4, 0}]) == 2);
+    BOOST_TEST((constGrid[Point{-5, -9}]) == 3);
+    BOOST_TEST((constGrid[Point{3, 3}]) == 4);
+    BOOST_TEST((constGrid[Point{0, 0}]) == -1);
+    BOOST_TEST((constGrid[Point{-1000, 1000}]) == -1);
+    BOOST_TEST(grid.chunkCount() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(Bool) {
+    InfiniteGrid<bool, 4> grid{false};
+    grid[Point{-3, 7}] = true;
+    const auto& constGrid = grid;
+    bool value = constGrid[Point{-3, 7}];
+    BOOST_TEST(value);
+    value = constGrid.get(Point{-2, 7});
+    BOOST_TEST(!value);
+    value = constGrid[Point{100, 100}];
+    BOOST_TEST(!value);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkCoordinates) {
+    typedef ChunkMap<int, 4> Chunks;
+    BOOST_CHECK_EQUAL(Chunks::chunkOf(Point(0, 3)), Point(0, 0));
+    BOOST_CHECK_EQUAL(Chunks::chunkOf(Point(4, -1)), Point(1, -1));
+    BOOST_CHECK_EQUAL(Chunks::chunkOf(Point(-4, -5)), Point(-1, -2));
+    BOOST_CHECK_EQUAL(Chunks::offsetIn(Point(-1, -5)), Point(3, 3));
+    BOOST_CHECK_EQUAL(Chunks::offsetIn(Point(-4, 5)), Point(0, 1));
+}
+
+BOOST_AUTO_TEST_CASE(BoundingBox) {
+    InfiniteGrid<int, 4> grid;
+    BOOST_CHECK(grid.boundingBox().empty());
+    grid[Point{1, 1}] = 1;
+    BOOST_CHECK_EQUAL(grid.boundingBox().beginPoint(), Point(0, 0));
+    BOOST_CHECK_EQUAL(grid.boundingBox().endPoint(), Point(4, 4));
+    grid[Point{-3, 9}] = 1;
+    BOOST_CHECK_EQUAL(grid.boundingBox().beginPoint(), Point(-4, 0));
+    BOOST_CHECK_EQUAL(grid.boundingBox().endPoint(), Point(4, 12));
+
+    grid[Point{-3, 9}] = 0;
+    grid.compact();
+    BOOST_TEST(grid.chunkCount() == 1);
+    BOOST_CHECK_EQUAL(grid.boundingBox().beginPoint(), Point(0, 0));
+    BOOST_CHECK_EQUAL(grid.boundingBox().endPoint(), Point(4, 4));
+
+    grid.clear();
+    BOOST_CHECK(grid.boundingBox().empty());
+}
+
+BOOST_AUTO_TEST_CASE(BoundingBoxAtTheLimits) {
+    InfiniteGrid<int, 4> grid;
+    grid[Point{INT_MAX, INT_MAX - 5}] = 1;
+    BOOST_CHECK_EQUAL(grid.boundingBox().beginPoint(),
+            Point(INT_MAX - 3, INT_MAX - 7));
+    BOOST_CHECK_EQUAL(grid.boundingBox().endPoint(),
+            Point(INT_MAX, INT_MAX - 3));
+    grid[Point{INT_MIN, 0}] = 1;
+    BOOST_CHECK_EQUAL(grid.boundingBox().beginPoint(), Point(INT_MIN, 0));
+
+    InfiniteGrid<int, 1> cells;
+    cells[Point{INT_MAX, INT_MIN}] = 1;
+    BOOST_CHECK_EQUAL(cells.boundingBox().beginPoint(),
+            Point(INT_MAX, INT_MIN));
+    BOOST_CHECK_EQUAL(cells.boundingBox().endPoint(),
+            Point(INT_MAX, INT_MIN + 1));
+}
+
+BOOST_AUTO_TEST_CASE(CellsAtTheLimits) {
+    InfiniteGrid<int, 3> grid{-1};
+    grid[Point{INT_MIN, INT_MAX}] = 1;
+    grid[Point{INT_MIN + 1, INT_MAX - 1}] = 2;
+    const auto& constGrid = grid;
+    BOOST_TEST((constGrid[Point{INT_MIN, INT_MAX}]) == 1);
+    BOOST_TEST((constGrid[Point{INT_MIN + 1, INT_MAX - 1}]) == 2);
+    BOOST_TEST((constGrid[Point{INT_MIN + 1, INT_MAX}]) == -1);
+    BOOST_CHECK_EQUAL((ChunkMap<int, 3>::offsetIn(Point(INT_MIN, INT_MAX))),
+            Point(1, 1));
+}
+
+BOOST_AUTO_TEST_CASE(ChunksDoNotMove) {
+    InfiniteGrid<int, 4> grid;
+    int& cell = grid[Point{0, 0}];
+    cell = 5;
+    for (int i = 1; i < 100; ++i) {
+        grid[Point{-4 * i, 4 * i}] = i;
+    }
+    BOOST_TEST((&grid[Point{0, 0}] == &cell));
+    BOOST_TEST(cell == 5);
+}
+
+BOOST_AUTO_TEST_CASE(ToMatrix) {
+    InfiniteGrid<int, 4> grid{0};
+    grid[Point{-1, -1}] = 1;
+    grid[Point{2, 0}] = 2;
+    Matrix<int> matrix = grid.toMatrix(PointRange{Point{-2, -1}, Point{3, 1}});
+    BOOST_CHECK_EQUAL(matrix, (Matrix<int>{5, 2, {
+            0, 1, 0, 0, 0,
+            0, 0, 0, 0, 2}}));
+
+    Matrix<int> all = grid.toMatrix();
+    BOOST_TEST(all.width() == 8);
+    BOOST_TEST(all.height() == 8);
+    BOOST_TEST((all[Point{3, 3}]) == 1);
+    BOOST_TEST((all[Point{6, 4}]) == 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // InfiniteGridTest
@@ -0,0 +1,134 @@
+#include "matrix/JumpPointSearch.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/optional/optional_io.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+namespace {
+
+template<typename Neighborhood>
+Matrix<int> toCosts(const Matrix<bool>& map) {
+    Matrix<int> result{map.width(), map.height()};
+    for (Point p : matrixRange(map)) {
+        result[p] = map[p] ? 1 : PathFinder<Neighborhood>::impassable;
+    }
+    return result;
+}
+
+template<typename Neighborhood>
+void checkPath(const std::vector<Point>& path, const Matrix<bool>& map,
+        Point start, Point goal, int cost) {
+    BOOST_TEST_REQUIRE(path.size() == static_cast<std::size_t>(cost) + 1);
+    BOOST_TEST(path.front() == start);
+    BOOST_TEST(path.back() == goal);
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        Point step = path[i] - path[i - 1];
+        const auto& offsets = Neighborhood{}.offsets(path[i - 1]);
+        BOOST_TEST_REQUIRE(std::count(offsets.begin(), offsets.end(), step)
+                == 1);
+        BOOST_TEST_REQUIRE(map[path[i]]);
+        if (step.x != 0 && step.y != 0) {
+            BOOST_TEST_REQUIRE((map[Point{path[i].x, path[i - 1].y}]));
+            BOOST_TEST_REQUIRE((map[Point{path[i - 1].x, path[i].y}]));
+        }
+    }
+}
+
+template<typename Neighborhood, typename Passability>
+void checkAgainstAStar(const Matrix<bool>& map,
+        const Passability& passability) {
+    Matrix<int> costs = toCosts<Neighborhood>(map);
+    PathFinder<Neighborhood> pathFinder;
+    JumpPointSearch<Neighborhood> jumpPointSearch;
+    int width = map.width();
+    int height = map.height();
+    for (int i = 0; i < 60; ++i) {
+        Point start{(i * 7) % width, (i * 5) % height};
+        Point goal{(i * 31 + 3) % width, (i * 17 + 11) % height};
+        BOOST_TEST_CONTEXT("start " << start << " goal " << goal) {
+            auto cost = jumpPointSearch.findPath(passability, start, goal);
+            boost::optional<int> expected;
+            if (map[start]) {
+                expected = pathFinder.findPath(costs, start, goal);
+            }
+            BOOST_TEST_REQUIRE(cost == expected);
+            if (cost) {
+                checkPath<Neighborhood>(jumpPointSearch.path(), map, start,
+                        goal, *cost);
+            } else {
+                BOOST_TEST(jumpPointSearch.path().empty());
+            }
+        }
+    }
+}
+
+template<typename Neighborhood>
+void checkRandomMaps() {
+    for (Point size : {Point{12, 9}, Point{40, 30}, Point{150, 12}}) {
+        for (unsigned seed = 0; seed < 4; ++seed) {
+            for (unsigned walls : {10u, 25u, 40u}) {
+                BOOST_TEST_CONTEXT("size " << size << " seed " << seed
+                        << " walls " << walls) {
+                    Matrix<bool> map = createRandomMap(size.x, size.y, seed,
+                            walls);
+                    checkAgainstAStar<Neighborhood>(map, map);
+                    checkAgainstAStar<Neighborhood>(map, BitMatrix{map});
+                }
+            }
+        }
+    }
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(JumpPointSearchTest)
+
+BOOST_AUTO_TEST_CASE(Diagonal) {
+    checkRandomMaps<SquareDiagonalNeighborhood>();
+}
+
+BOOST_AUTO_TEST_CASE(Straight) {
+    checkRandomMaps<SquareNeighborhood>();
+}
+
+BOOST_AUTO_TEST_CASE(StartIsGoal) {
+    Matrix<bool> map{3, 3, true};
+    JumpPointSearch<SquareDiagonalNeighborhood> jumpPointSearch;
+    BOOST_TEST(jumpPointSearch.findPath(map, p11, p11) == 0);
+    BOOST_TEST(jumpPointSearch.path() == std::vector<Point>{p11});
+}
+
+BOOST_AUTO_TEST_CASE(Unreachable) {
+    Matrix<bool> map{5, 3, true};
+    for (int y = 0; y < 3; ++y) {
+        map[Point{2, y}] = false;
+    }
+    JumpPointSearch<SquareDiagonalNeighborhood> jumpPointSearch;
+    BOOST_TEST(!jumpPointSearch.findPath(map, p00, Point{4, 2}));
+    BOOST_TEST(jumpPointSearch.jumpPoints().empty());
+    BOOST_TEST(!jumpPointSearch.findPath(BitMatrix{map}, p00, Point{2, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(NoCornerCutting) {
+    Matrix<bool> map{3, 3, true};
+    map[Point{1, 0}] = false;
+    JumpPointSearch<SquareDiagonalNeighborhood> jumpPointSearch;
+    BOOST_TEST(jumpPointSearch.findPath(map, p00, Point{2, 0}) == 4);
+}
+
+BOOST_AUTO_TEST_CASE(OpenFieldExpandsFewNodes) {
+    Matrix<bool> map{200, 200, true};
+    map[Point{100, 100}] = false;
+    BitMatrix bits{map};
+    JumpPointSearch<SquareDiagonalNeighborhood> jumpPointSearch;
+    BOOST_TEST(jumpPointSearch.findPath(bits, Point{3, 190}, Point{195, 7})
+            == 192);
+    BOOST_TEST(jumpPointSearch.expandedCount() < 10u);
+    BOOST_TEST(jumpPointSearch.jumpPoints().size() <= 4u);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // JumpPointSearchTest
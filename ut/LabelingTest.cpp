@@ -0,0 +1,161 @@
+#include "matrix/Labeling.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <deque>
+#include <limits>
+
+using namespace util;
+using namespace util::matrix;
+
+namespace {
+
+// Three labels forming irregular regions of varying size.
+Matrix<int> createRegions(std::size_t width, std::size_t height) {
+    Matrix<int> result{width, height};
+    for (Point p : matrixRange(result)) {
+        result[p] = ((p.x * 7 + p.y * 13) ^ (p.x * p.y)) % 3;
+    }
+    return result;
+}
+
+// Breadth-first search from every unlabeled cell in row-major order.
+template<typename Neighborhood, typename Equivalent>
+Matrix<std::uint32_t> labelNaively(const Matrix<int>& matrix,
+        const Neighborhood& neighborhood, Equivalent equivalent) {
+    const std::uint32_t unlabeled = std::numeric_limits<std::uint32_t>::max();
+    Matrix<std::uint32_t> result{matrix.width(), matrix.height(), unlabeled};
+    std::uint32_t next = 0;
+    for (Point start : matrixRange(matrix)) {
+        if (result[start] != unlabeled) {
+            continue;
+        }
+        std::deque<Point> queue{start};
+        result[start] = next;
+        while (!queue.empty()) {
+            Point p = queue.front();
+            queue.pop_front();
+            for (Point offset : neighborhood.offsets(p)) {
+                Point q = p + offset;
+                if (isInsideMatrix(matrix, q) && result[q] == unlabeled &&
+                        equivalent(matrix[p], matrix[q])) {
+                    result[q] = next;
+                    queue.push_back(q);
+                }
+            }
+        }
+        ++next;
+    }
+    return result;
+}
+
+void checkComponents(const Labeling& labeling) {
+    std::vector<std::size_t> sizes(labeling.components.size(), 0);
+    std::vector<Point> mins(labeling.components.size(),
+            Point{std::numeric_limits<int>::max(),
+                    std::numeric_limits<int>::max()});
+    std::vector<Point> maxes(labeling.components.size(), Point{-1, -1});
+    for (Point p : matrixRange(labeling.labels)) {
+        std::uint32_t label = labeling.labels[p];
+        BOOST_TEST_REQUIRE(label < labeling.components.size());
+        ++sizes[label];
+        mins[label] = Point{std::min(mins[label].x, p.x),
+                std::min(mins[label].y, p.y)};
+        maxes[label] = Point{std::max(maxes[label].x, p.x + 1),
+                std::max(maxes[label].y, p.y + 1)};
+    }
+    for (std::size_t i = 0; i < labeling.components.size(); ++i) {
+        const Component& component = labeling.components[i];
+        BOOST_TEST(component.size == sizes[i]);
+        BOOST_TEST(component.boundingBox.beginPoint() == mins[i]);
+        BOOST_TEST(component.boundingBox.endPoint() == maxes[i]);
+    }
+}
+
+template<typename Neighborhood, typename Equivalent = std::equal_to<>>
+void checkLabeling(const Neighborhood& neighborhood,
+        Equivalent equivalent = {}) {
+    ThreadPool threadPool{3};
+    ThreadPoolRunner runner{threadPool};
+    for (Point size : {Point{1, 1}, Point{5, 1}, Point{1, 6}, Point{8, 8},
+            Point{23, 17}}) {
+        BOOST_TEST_CONTEXT("size " << size) {
+            Matrix<int> matrix = createRegions(size.x, size.y);
+            auto expected = labelNaively(matrix, neighborhood, equivalent);
+            Labeling labeling = labelComponents(matrix, neighborhood,
+                    equivalent);
+            BOOST_TEST(labeling.labels == expected);
+            checkComponents(labeling);
+
+            for (std::size_t grain : {0, 1, 2, 5}) {
+                BOOST_TEST_CONTEXT("grain " << grain) {
+                    Labeling parallelLabeling = labelComponents(threadPool,
+                            matrix, neighborhood, equivalent, grain);
+                    BOOST_TEST(parallelLabeling.labels == expected);
+                    checkComponents(parallelLabeling);
+                }
+            }
+        }
+    }
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(LabelingTest)
+
+BOOST_AUTO_TEST_CASE(Square) {
+    checkLabeling(SquareNeighborhood{});
+}
+
+BOOST_AUTO_TEST_CASE(SquareDiagonal) {
+    checkLabeling(SquareDiagonalNeighborhood{});
+}
+
+BOOST_AUTO_TEST_CASE(Hex) {
+    checkLabeling(HexNeighborhood{});
+}
+
+BOOST_AUTO_TEST_CASE(CustomEquivalence) {
+    auto bothZero = [](int lhs, int rhs) { return (lhs == 0) == (rhs == 0); };
+    checkLabeling(SquareNeighborhood{}, bothZero);
+    checkLabeling(HexNeighborhood{}, bothZero);
+}
+
+BOOST_AUTO_TEST_CASE(Example) {
+    Matrix<int> matrix{5, 4, {
+            1, 1, 0, 0, 1,
+            0, 1, 0, 1, 1,
+            0, 0, 1, 0, 0,
+            1, 0, 0, 0, 1}};
+    Labeling square = labelComponents(matrix, SquareNeighborhood{});
+    BOOST_TEST(square.components.size() == 7u);
+    BOOST_TEST(square.components[0].size == 3u);
+    BOOST_TEST((square.labels[Point{1, 1}]) == 0u);
+    BOOST_TEST((square.labels[Point{2, 1}]) == 1u);
+    BOOST_TEST((square.labels[Point{4, 3}]) == 6u);
+    BOOST_TEST(square.components[3].size == 8u);
+    BOOST_TEST(square.components[3].boundingBox.beginPoint() == p01);
+    BOOST_TEST(square.components[3].boundingBox.endPoint() ==
+            (Point{5, 4}));
+
+    Labeling diagonal = labelComponents(matrix, SquareDiagonalNeighborhood{});
+    BOOST_TEST(diagonal.components.size() == 4u);
+    BOOST_TEST(diagonal.components[0].size == 7u);
+    BOOST_TEST(diagonal.components[1].size == 11u);
+    BOOST_TEST((diagonal.labels[Point{4, 0}]) == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(Empty) {
+    Labeling labeling = labelComponents(Matrix<int>{}, SquareNeighborhood{});
+    BOOST_TEST(labeling.labels.size() == 0u);
+    BOOST_TEST(labeling.components.empty());
+}
+
+BOOST_AUTO_TEST_CASE(LargeComponentDoesNotRecurse) {
+    Matrix<int> matrix{1000, 1000, 0};
+    Labeling labeling = labelComponents(matrix, SquareNeighborhood{});
+    BOOST_TEST(labeling.components.size() == 1u);
+    BOOST_TEST(labeling.components[0].size == 1000000u);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // LabelingTest
@@ -0,0 +1,96 @@
+#include "matrix/LayoutMatrix.hpp"
+#include "matrix/MatrixIO.hpp"
+
+#include <boost/mpl/list.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <unordered_set>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(LayoutMatrixTest)
+
+using Layouts = boost::mpl::list<RowMajorLayout, TiledLayout<1>,
+        TiledLayout<8>, TiledLayout<16>, MortonLayout>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(IndicesAreUnique, Layout, Layouts) {
+    for (Point size : {Point{1, 1}, Point{8, 8}, Point{13, 5},
+            Point{3, 40}, Point{64, 17}}) {
+        Layout layout{static_cast<std::size_t>(size.x),
+                static_cast<std::size_t>(size.y)};
+        std::unordered_set<std::size_t> indices;
+        for (Point p : PointRange{p00, size}) {
+            std::size_t index = layout.index(p);
+            BOOST_TEST_REQUIRE(index < layout.size());
+            BOOST_TEST_REQUIRE(indices.insert(index).second);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TiledLayoutKeepsTilesTogether) {
+    TiledLayout<4> layout{10, 10};
+    BOOST_TEST(layout.index(Point{0, 0}) == 0);
+    BOOST_TEST(layout.index(Point{3, 0}) == 3);
+    BOOST_TEST(layout.index(Point{0, 1}) == 4);
+    BOOST_TEST(layout.index(Point{3, 3}) == 15);
+    BOOST_TEST(layout.index(Point{4, 0}) == 16);
+    BOOST_TEST(layout.index(Point{0, 4}) == 48);
+}
+
+BOOST_AUTO_TEST_CASE(MortonLayoutInterleaves) {
+    MortonLayout layout{8, 8};
+    BOOST_TEST(layout.size() == 64);
+    BOOST_TEST(layout.index(Point{1, 0}) == 1);
+    BOOST_TEST(layout.index(Point{0, 1}) == 2);
+    BOOST_TEST(layout.index(Point{1, 1}) == 3);
+    BOOST_TEST(layout.index(Point{2, 0}) == 4);
+    BOOST_TEST(layout.index(Point{7, 7}) == 63);
+}
+
+BOOST_AUTO_TEST_CASE(MortonLayoutRectangle) {
+    MortonLayout layout{16, 4};
+    BOOST_TEST(layout.size() == 64);
+    BOOST_TEST(layout.index(Point{3, 3}) == 15);
+    BOOST_TEST(layout.index(Point{4, 0}) == 16);
+    BOOST_TEST(layout.index(Point{15, 3}) == 63);
+}
+
+using Matrices = boost::mpl::list<LayoutMatrix<int, RowMajorLayout>,
+        TiledMatrix<int>, TiledMatrix<int, 4>, MortonMatrix<int>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(SetAndGet, MatrixType, Matrices) {
+    MatrixType matrix{11, 7, -1};
+    BOOST_TEST(matrix.width() == 11);
+    BOOST_TEST(matrix.height() == 7);
+    BOOST_TEST(matrix.size() == 77);
+    for (Point p : matrixRange(matrix)) {
+        BOOST_CHECK_EQUAL(matrix[p], -1);
+        matrix[p] = p.x * 100 + p.y;
+    }
+    for (Point p : matrixRange(matrix)) {
+        BOOST_CHECK_EQUAL(matrix[p], p.x * 100 + p.y);
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ConvertFromAndToMatrix, MatrixType, Matrices) {
+    Matrix<int> matrix{3, 2, {1, 2, 3, 4, 5, 6}};
+    MatrixType converted{matrix};
+    BOOST_CHECK_EQUAL((converted[Point{2, 0}]), 3);
+    BOOST_CHECK_EQUAL((converted[Point{0, 1}]), 4);
+    BOOST_CHECK_EQUAL(converted.toMatrix(), matrix);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(ResetAndCompare, MatrixType, Matrices) {
+    MatrixType matrix1{2, 2};
+    matrix1.reset(5, 3, 4);
+    MatrixType matrix2{5, 3, 4};
+    BOOST_CHECK(matrix1 == matrix2);
+    matrix2[Point{4, 2}] = 0;
+    BOOST_CHECK(matrix1 != matrix2);
+    matrix1.fill(0);
+    BOOST_CHECK_EQUAL((matrix1[Point{3, 1}]), 0);
+    matrix1.clear();
+    BOOST_TEST(matrix1.width() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // LayoutMatrixTest
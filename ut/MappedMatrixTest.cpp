@@ -0,0 +1,120 @@
+#include "matrix/MappedMatrix.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <system_error>
+
+#include <unistd.h>
+
+using namespace util;
+using namespace util::matrix;
+
+namespace {
+
+struct Fixture {
+    std::string fileName = "/tmp/MappedMatrixTest." +
+            std::to_string(::getpid()) + ".umtx";
+
+    ~Fixture() {
+        std::remove(fileName.c_str());
+    }
+};
+
+} // unnamed namespace
+
+BOOST_FIXTURE_TEST_SUITE(MappedMatrixTest, Fixture)
+
+BOOST_AUTO_TEST_CASE(CreateAndOpen) {
+    {
+        auto matrix = MappedMatrix<int>::create(fileName, 3, 2, 5);
+        BOOST_TEST(matrix.width() == 3);
+        BOOST_TEST(matrix.height() == 2);
+        BOOST_TEST((matrix[Point{2, 1}]) == 5);
+        matrix[Point{1, 0}] = 42;
+    }
+    auto matrix = MappedMatrix<int>::open(fileName);
+    BOOST_CHECK(matrix.mode() == MapMode::readOnly);
+    BOOST_TEST(matrix.width() == 3);
+    BOOST_TEST(matrix.height() == 2);
+    BOOST_TEST((matrix[Point{1, 0}]) == 42);
+    BOOST_TEST((matrix[Point{0, 1}]) == 5);
+    BOOST_CHECK(matrix.toMatrix() == (Matrix<int>{3, 2, {5, 42, 5, 5, 5, 5}}));
+}
+
+BOOST_AUTO_TEST_CASE(CreateFromMatrix) {
+    Matrix<double> source{2, 2, {1.5, 2.5, 3.5, 4.5}};
+    MappedMatrix<double>::create(fileName, source).flush();
+    auto matrix = MappedMatrix<double>::open(fileName, MapMode::readOnly,
+            true);
+    matrix.advise(AccessHint::sequential);
+    BOOST_CHECK_EQUAL_COLLECTIONS(matrix.begin(), matrix.end(),
+            source.begin(), source.end());
+}
+
+BOOST_AUTO_TEST_CASE(ReadWrite) {
+    MappedMatrix<int>::create(fileName, 4, 4, 0);
+    {
+        auto matrix = MappedMatrix<int>::open(fileName, MapMode::readWrite);
+        matrix[Point{3, 3}] = 7;
+    }
+    auto matrix = MappedMatrix<int>::open(fileName);
+    BOOST_TEST((matrix[Point{3, 3}]) == 7);
+}
+
+BOOST_AUTO_TEST_CASE(CopyOnWrite) {
+    MappedMatrix<int>::create(fileName, 4, 4, 0);
+    {
+        auto matrix = MappedMatrix<int>::open(fileName, MapMode::copyOnWrite);
+        matrix[Point{3, 3}] = 7;
+        BOOST_TEST((matrix[Point{3, 3}]) == 7);
+    }
+    auto matrix = MappedMatrix<int>::open(fileName);
+    BOOST_TEST((matrix[Point{3, 3}]) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyMatrix) {
+    MappedMatrix<int>::create(fileName, 0, 0);
+    auto matrix = MappedMatrix<int>::open(fileName);
+    BOOST_TEST(matrix.size() == 0);
+    BOOST_CHECK(matrix.begin() == matrix.end());
+}
+
+BOOST_AUTO_TEST_CASE(ElementSizeMismatch) {
+    MappedMatrix<int>::create(fileName, 2, 2);
+    BOOST_CHECK_THROW(MappedMatrix<double>::open(fileName), MatrixFileError);
+}
+
+BOOST_AUTO_TEST_CASE(TruncatedFile) {
+    MappedMatrix<int>::create(fileName, 2, 2);
+    BOOST_TEST(::truncate(fileName.c_str(), 70) == 0);
+    BOOST_CHECK_THROW(MappedMatrix<int>::open(fileName), MatrixFileError);
+}
+
+BOOST_AUTO_TEST_CASE(OverflowingSize) {
+    // 2^33 * 2^33 * 4 wraps around to 0.
+    MatrixFileHeader header = makeMatrixFileHeader(sizeof(int),
+            std::uint64_t{1} << 33, std::uint64_t{1} << 33);
+    std::ofstream{fileName, std::ios::binary}.write(
+            reinterpret_cast<const char*>(&header), sizeof(header));
+    BOOST_CHECK_THROW(MappedMatrix<int>::open(fileName), MatrixFileError);
+    BOOST_CHECK_THROW(MappedMatrix<int>::create(fileName,
+            std::size_t{1} << 33, std::size_t{1} << 33), MatrixFileError);
+    BOOST_CHECK_THROW(MappedMatrix<char>::create(fileName,
+            std::numeric_limits<std::size_t>::max(), 1), MatrixFileError);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidFile) {
+    std::ofstream{fileName} << "this is not a matrix file, but it is long "
+            "enough to contain a header if it were one";
+    BOOST_CHECK_THROW(MappedMatrix<int>::open(fileName), MatrixFileError);
+}
+
+BOOST_AUTO_TEST_CASE(MissingFile) {
+    BOOST_CHECK_THROW(MappedMatrix<int>::open(fileName), std::system_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // MappedMatrixTest
@@ -0,0 +1,115 @@
+#include "matrix/AlignedMatrix.hpp"
+#include "matrix/LayoutMatrix.hpp"
+#include "matrix/Matrix.hpp"
+#include "matrix/MatrixCompare.hpp"
+#include "matrix/MatrixView.hpp"
+#include "matrix/PersistentMatrix.hpp"
+#include "matrix/SparseMatrix.hpp"
+
+#include <boost/optional/optional_io.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <string>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(MatrixCompareTest)
+
+BOOST_AUTO_TEST_CASE(DimensionsComeFirst) {
+    Matrix<int> matrix1{2, 3, 0};
+    Matrix<int> matrix2{3, 2, 0};
+    BOOST_CHECK(!(matrix1 == matrix2));
+    BOOST_CHECK(matrix1 < matrix2);
+    BOOST_CHECK(!(matrix2 < matrix1));
+    BOOST_TEST(compare(matrix1, matrix2) < 0);
+    BOOST_TEST(compare(Matrix<int>{2, 4, -5}, matrix1) > 0);
+}
+
+BOOST_AUTO_TEST_CASE(OrderingUsesElementOrder) {
+    // memcmp would order these the other way.
+    Matrix<char> negative{1, 1, {static_cast<char>(-1)}};
+    Matrix<char> positive{1, 1, {1}};
+    BOOST_CHECK(negative < positive);
+    BOOST_TEST(compare(negative, positive) == -1);
+
+    Matrix<int> small{2, 1, {256, 0}};
+    Matrix<int> large{2, 1, {1, 1}};
+    BOOST_CHECK(large < small);
+    BOOST_TEST(compare(small, large) == 1);
+    BOOST_TEST(compare(small, small) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(FirstDifference) {
+    Matrix<std::int16_t> matrix1{300, 3, 7};
+    Matrix<std::int16_t> matrix2 = matrix1;
+    BOOST_CHECK_EQUAL(firstDifference(matrix1, matrix2), boost::none);
+    matrix2[Point{250, 1}] = 8;
+    matrix2[Point{10, 2}] = 8;
+    BOOST_CHECK_EQUAL(firstDifference(matrix1, matrix2),
+            boost::make_optional(Point{250, 1}));
+    matrix2[Point{0, 0}] = 8;
+    BOOST_CHECK_EQUAL(firstDifference(matrix1, matrix2),
+            boost::make_optional(Point{0, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(FirstDifferenceOfViews) {
+    Matrix<int> matrix{10, 10, 0};
+    AlignedMatrix<int> aligned{3, 3, 0};
+    auto view = matrixView(matrix, Point{2, 2}, 3, 3);
+    BOOST_CHECK_EQUAL(firstDifference(view, aligned), boost::none);
+    BOOST_TEST(compare(view, aligned) == 0);
+    matrix[Point{3, 4}] = 1;
+    BOOST_CHECK_EQUAL(firstDifference(view, aligned),
+            boost::make_optional(Point{1, 2}));
+    BOOST_TEST(compare(view, aligned) > 0);
+}
+
+BOOST_AUTO_TEST_CASE(NonBytewiseTypes) {
+    Matrix<std::string> matrix1{2, 1, {"a", "b"}};
+    Matrix<std::string> matrix2{2, 1, {"a", "c"}};
+    BOOST_CHECK_EQUAL(firstDifference(matrix1, matrix2),
+            boost::make_optional(Point{1, 0}));
+    BOOST_CHECK(matrix1 < matrix2);
+    BOOST_TEST(compare(matrix2, matrix1) == 1);
+
+    Matrix<bool> bools1{2, 2, false};
+    Matrix<bool> bools2{2, 2, false};
+    BOOST_CHECK(bools1 == bools2);
+    bools2[Point{1, 1}] = true;
+    BOOST_CHECK(bools1 != bools2);
+    BOOST_CHECK(bools1 < bools2);
+
+    Matrix<double> doubles1{1, 1, {0.0}};
+    Matrix<double> doubles2{1, 1, {-0.0}};
+    BOOST_CHECK(doubles1 == doubles2);
+}
+
+BOOST_AUTO_TEST_CASE(MatricesWithoutRowData) {
+    Matrix<int> matrix{5, 4, 1};
+    matrix[Point{3, 2}] = 2;
+    TiledMatrix<int, 2> tiled{5, 4, 1};
+    SparseMatrix<int, 2> sparse{5, 4, 1};
+    PersistentMatrix<int, 2> persistent{5, 4, 1};
+    BOOST_CHECK_EQUAL(firstDifference(matrix, tiled),
+            boost::make_optional(Point{3, 2}));
+    BOOST_CHECK_EQUAL(firstDifference(sparse, matrix),
+            boost::make_optional(Point{3, 2}));
+    BOOST_TEST(compare(persistent, matrix) < 0);
+    BOOST_TEST(compare(tiled, sparse) == 0);
+    persistent[Point{3, 2}] = 2;
+    BOOST_TEST(compare(persistent, matrix) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(OrderedSet) {
+    std::set<Matrix<char>> set;
+    set.insert(Matrix<char>{2, 2, 'a'});
+    set.insert(Matrix<char>{4, 1, 'a'});
+    set.insert(Matrix<char>{1, 4, 'a'});
+    set.insert(Matrix<char>{2, 2, 'a'});
+    set.insert(Matrix<char>{2, 2, 'b'});
+    BOOST_TEST(set.size() == 4);
+    BOOST_TEST(set.begin()->width() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // MatrixCompareTest
@@ -0,0 +1,174 @@
+#include "matrix/AlignedMatrix.hpp"
+#include "matrix/LayoutMatrix.hpp"
+#include "matrix/Matrix.hpp"
+#include "matrix/MatrixHash.hpp"
+#include "matrix/MatrixView.hpp"
+#include "matrix/SparseMatrix.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace util::matrix;
+
+namespace {
+
+std::uint64_t hashString(const std::string& s, std::uint64_t seed = 0) {
+    Hasher64 hasher{seed};
+    hasher.update(s.data(), s.size());
+    return hasher.finish();
+}
+
+// Chi-square statistic of the distribution of the given hash bits into
+// 256 buckets.
+double chiSquare(const std::vector<std::uint64_t>& hashes, int shift) {
+    std::vector<double> buckets(256, 0.0);
+    for (std::uint64_t hash : hashes) {
+        ++buckets[(hash >> shift) & 0xff];
+    }
+    double expected = static_cast<double>(hashes.size()) / buckets.size();
+    double result = 0.0;
+    for (double count : buckets) {
+        result += (count - expected) * (count - expected) / expected;
+    }
+    return result;
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(MatrixHashTest)
+
+BOOST_AUTO_TEST_CASE(KnownValues) {
+    BOOST_TEST(hashString("") == 0xEF46DB3751D8E999ULL);
+    BOOST_TEST(hashString("a") == 0xD24EC4F1A98C6E5BULL);
+    BOOST_TEST(hashString("abc") == 0x44BC2CF5AD770999ULL);
+    std::string bytes;
+    for (int i = 0; i < 100; ++i) {
+        bytes += static_cast<char>(i);
+    }
+    BOOST_TEST(hashString(bytes) == 0x6AC1E58032166597ULL);
+    BOOST_TEST(hashString(bytes, 12345) == 0x028BA1AE2DE4DE27ULL);
+}
+
+BOOST_AUTO_TEST_CASE(StreamingDoesNotDependOnSplit) {
+    std::string bytes;
+    for (int i = 0; i < 200; ++i) {
+        bytes += static_cast<char>(i * 7);
+    }
+    std::uint64_t expected = hashString(bytes, 3);
+    for (std::size_t chunk : {1, 3, 8, 31, 32, 33, 100}) {
+        Hasher64 hasher{3};
+        for (std::size_t i = 0; i < bytes.size(); i += chunk) {
+            hasher.update(bytes.data() + i,
+                    std::min(chunk, bytes.size() - i));
+        }
+        BOOST_TEST(hasher.finish() == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DimensionsAreHashed) {
+    Matrix<int> matrix1{2, 3, 0};
+    Matrix<int> matrix2{3, 2, 0};
+    BOOST_TEST(hashMatrix(matrix1) != hashMatrix(matrix2));
+    BOOST_TEST(std::hash<Matrix<int>>{}(matrix1) !=
+            std::hash<Matrix<int>>{}(matrix2));
+    BOOST_TEST(hashMatrix(Matrix<int>{0, 5}) != hashMatrix(Matrix<int>{5, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(SubRectangleHashesLikeCopy) {
+    Matrix<int> matrix{6, 5};
+    for (Point p : matrixRange(matrix)) {
+        matrix[p] = p.x * 10 + p.y;
+    }
+    Matrix<int> copy{3, 2};
+    for (Point p : matrixRange(copy)) {
+        copy[p] = matrix[p + Point{2, 1}];
+    }
+    BOOST_TEST(hashMatrix(matrix, Point{2, 1}, 3, 2) == hashMatrix(copy));
+    BOOST_TEST(hashMatrix(matrixView(matrix, Point{2, 1}, 3, 2)) ==
+            hashMatrix(copy));
+    BOOST_TEST(hashMatrix(AlignedMatrix<int>{copy}) == hashMatrix(copy));
+}
+
+BOOST_AUTO_TEST_CASE(MatricesWithoutRowData) {
+    Matrix<int> matrix{7, 5, 3};
+    matrix[Point{6, 1}] = -4;
+    TiledMatrix<int, 4> tiled{matrix};
+    SparseMatrix<int, 4> sparse{7, 5, 3};
+    sparse[Point{6, 1}] = -4;
+    BOOST_TEST(hashMatrix(tiled) == hashMatrix(matrix));
+    BOOST_TEST(hashMatrix(sparse) == hashMatrix(matrix));
+    BOOST_TEST(hashMatrix(sparse, Point{5, 1}, 2, 3) ==
+            hashMatrix(matrix, Point{5, 1}, 2, 3));
+    sparse[Point{0, 0}] = 0;
+    BOOST_TEST(hashMatrix(sparse) != hashMatrix(matrix));
+}
+
+BOOST_AUTO_TEST_CASE(NonBytewiseTypes) {
+    Matrix<bool> matrix1{3, 3, false};
+    Matrix<bool> matrix2{3, 3, false};
+    matrix2[Point{1, 1}] = true;
+    BOOST_TEST(hashMatrix(matrix1) != hashMatrix(matrix2));
+    BOOST_TEST(hashMatrix(matrix1) == hashMatrix(Matrix<bool>{3, 3, false}));
+
+    Matrix<std::string> strings{2, 1, {"a", "b"}};
+    BOOST_TEST(hashMatrix(strings) ==
+            hashMatrix(Matrix<std::string>{2, 1, {"a", "b"}}));
+    BOOST_TEST(hashMatrix(strings) !=
+            hashMatrix(Matrix<std::string>{2, 1, {"b", "a"}}));
+}
+
+BOOST_AUTO_TEST_CASE(PointMatrix) {
+    Matrix<Point> matrix{2, 2, Point{1, 2}};
+    Matrix<Point> other = matrix;
+    BOOST_TEST(hashMatrix(matrix) == hashMatrix(other));
+    other[Point{1, 1}] = Point{2, 1};
+    BOOST_TEST(hashMatrix(matrix) != hashMatrix(other));
+}
+
+// Every 4x4 matrix of zeros and ones: the hashes must be unique and evenly
+// distributed in both the low and the high bits.
+BOOST_AUTO_TEST_CASE(CollisionQuality) {
+    std::vector<std::uint64_t> hashes;
+    hashes.reserve(1 << 16);
+    Matrix<std::uint8_t> matrix{4, 4};
+    for (unsigned bits = 0; bits < (1u << 16); ++bits) {
+        for (std::size_t i = 0; i < matrix.size(); ++i) {
+            matrix[i] = (bits >> i) & 1;
+        }
+        hashes.push_back(hashMatrix(matrix));
+    }
+    std::unordered_set<std::uint64_t> unique(hashes.begin(), hashes.end());
+    BOOST_TEST(unique.size() == hashes.size());
+    // The 0.9999 quantile of the chi-square distribution with 255 degrees of
+    // freedom is about 360.
+    for (int shift : {0, 8, 28, 56}) {
+        BOOST_TEST_CONTEXT("shift " << shift) {
+            BOOST_TEST(chiSquare(hashes, shift) < 360.0);
+        }
+    }
+}
+
+// Changing a single bit of a cell changes about half of the hash bits.
+BOOST_AUTO_TEST_CASE(Avalanche) {
+    Matrix<std::uint32_t> matrix{8, 8, 0};
+    std::uint64_t original = hashMatrix(matrix);
+    long changedBits = 0;
+    int samples = 0;
+    for (std::size_t i = 0; i < matrix.size(); ++i) {
+        for (int bit = 0; bit < 32; ++bit) {
+            matrix[i] ^= 1u << bit;
+            changedBits += __builtin_popcountll(hashMatrix(matrix) ^ original);
+            ++samples;
+            matrix[i] ^= 1u << bit;
+        }
+    }
+    double average = static_cast<double>(changedBits) / samples;
+    BOOST_TEST(average > 31.0);
+    BOOST_TEST(average < 33.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // MatrixHashTest
@@ -0,0 +1,229 @@
+#include "matrix/AlignedMatrix.hpp"
+#include "matrix/MatrixKernels.hpp"
+#include "matrix/MatrixView.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace util::matrix;
+using namespace util::matrix::kernels;
+using namespace util::matrix::test;
+
+namespace {
+
+const std::vector<SimdLevel> simdLevels{
+        SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2};
+
+const std::vector<Comparison> comparisons{
+        Comparison::less, Comparison::lessEqual, Comparison::equal,
+        Comparison::notEqual, Comparison::greaterEqual, Comparison::greater};
+
+bool compare(double lhs, Comparison comparison, double rhs) {
+    switch (comparison) {
+    case Comparison::less: return lhs < rhs;
+    case Comparison::lessEqual: return lhs <= rhs;
+    case Comparison::equal: return lhs == rhs;
+    case Comparison::notEqual: return lhs != rhs;
+    case Comparison::greaterEqual: return lhs >= rhs;
+    default: return lhs > rhs;
+    }
+}
+
+// Runs the test for every supported SIMD level and for several sizes,
+// including ones that are not multiples of the vector widths.
+template<typename Function>
+void forEachSetup(Function function) {
+    SimdLevel originalLevel = getSimdLevel();
+    for (SimdLevel level : simdLevels) {
+        if (level > getSupportedSimdLevel()) {
+            continue;
+        }
+        setSimdLevel(level);
+        for (Point size : {Point{1, 1}, Point{3, 1}, Point{8, 2},
+                Point{13, 5}, Point{64, 3}, Point{100, 7}}) {
+            BOOST_TEST_CONTEXT("level " << static_cast<int>(level)
+                    << " size " << size) {
+                function(static_cast<std::size_t>(size.x),
+                        static_cast<std::size_t>(size.y));
+            }
+        }
+    }
+    setSimdLevel(originalLevel);
+}
+
+template<typename MatrixType>
+void checkReductions(const MatrixType& matrix) {
+    using T = typename MatrixType::valueType;
+    double expectedSum = 0;
+    T expectedMin = matrix[p00];
+    T expectedMax = matrix[p00];
+    Point expectedArgMin = p00;
+    Point expectedArgMax = p00;
+    for (Point p : matrixRange(matrix)) {
+        expectedSum += matrix[p];
+        if (matrix[p] < expectedMin) {
+            expectedMin = matrix[p];
+            expectedArgMin = p;
+        }
+        if (matrix[p] > expectedMax) {
+            expectedMax = matrix[p];
+            expectedArgMax = p;
+        }
+    }
+    BOOST_TEST(static_cast<double>(sum(matrix)) == expectedSum);
+    BOOST_TEST(minValue(matrix) == expectedMin);
+    BOOST_TEST(maxValue(matrix) == expectedMax);
+    BOOST_TEST(argMin(matrix) == expectedArgMin);
+    BOOST_TEST(argMax(matrix) == expectedArgMax);
+}
+
+template<typename MatrixType>
+void checkComparisons(const MatrixType& matrix) {
+    for (Comparison comparison : comparisons) {
+        for (double value : {-11.0, -3.0, 0.0, 5.0, 20.0}) {
+            using T = typename MatrixType::valueType;
+            BitMatrix mask = compareToMask(matrix, comparison,
+                    static_cast<T>(value));
+            std::size_t expectedCount = 0;
+            for (Point p : matrixRange(matrix)) {
+                bool expected = compare(matrix[p], comparison, value);
+                BOOST_TEST_REQUIRE(mask[p] == expected);
+                expectedCount += expected ? 1 : 0;
+            }
+            BOOST_TEST(mask.count() == expectedCount);
+            BOOST_TEST(count(matrix, comparison, static_cast<T>(value)) ==
+                    expectedCount);
+        }
+    }
+}
+
+template<typename MatrixType>
+void checkClamp(MatrixType&& matrix) {
+    using T = typename std::decay_t<MatrixType>::valueType;
+    auto original = createMatrix<T>(matrix.width(), matrix.height());
+    clamp(matrix, -5, 7);
+    for (Point p : matrixRange(matrix)) {
+        BOOST_TEST_REQUIRE(matrix[p] ==
+                std::min(std::max(original[p], T(-5)), T(7)));
+    }
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(MatrixKernelsTest)
+
+BOOST_AUTO_TEST_CASE(SetSimdLevel) {
+    SimdLevel originalLevel = getSimdLevel();
+    setSimdLevel(SimdLevel::scalar);
+    BOOST_CHECK(getSimdLevel() == SimdLevel::scalar);
+    setSimdLevel(SimdLevel::avx2);
+    BOOST_CHECK(getSimdLevel() == getSupportedSimdLevel());
+    setSimdLevel(originalLevel);
+}
+
+BOOST_AUTO_TEST_CASE(Int32Reductions) {
+    forEachSetup([](std::size_t width, std::size_t height) {
+            checkReductions(createMatrix<std::int32_t>(width, height));
+        });
+}
+
+BOOST_AUTO_TEST_CASE(FloatReductions) {
+    forEachSetup([](std::size_t width, std::size_t height) {
+            checkReductions(createMatrix<float>(width, height));
+        });
+}
+
+BOOST_AUTO_TEST_CASE(GenericReductions) {
+    forEachSetup([](std::size_t width, std::size_t height) {
+            checkReductions(createMatrix<short>(width, height));
+            checkReductions(createMatrix<double>(width, height));
+        });
+}
+
+BOOST_AUTO_TEST_CASE(PaddedReductions) {
+    forEachSetup([](std::size_t width, std::size_t height) {
+            checkReductions(AlignedMatrix<std::int32_t>{
+                    createMatrix<std::int32_t>(width, height)});
+            Matrix<float> matrix = createMatrix<float>(width + 2, height + 1);
+            checkReductions(matrixView(matrix, p11, width, height));
+        });
+}
+
+BOOST_AUTO_TEST_CASE(Comparisons) {
+    forEachSetup([](std::size_t width, std::size_t height) {
+            checkComparisons(createMatrix<std::int32_t>(width, height));
+            checkComparisons(createMatrix<float>(width, height));
+            checkComparisons(createMatrix<long>(width, height));
+            checkComparisons(AlignedMatrix<float>{
+                    createMatrix<float>(width, height)});
+        });
+}
+
+BOOST_AUTO_TEST_CASE(Clamp) {
+    forEachSetup([](std::size_t width, std::size_t height) {
+            checkClamp(createMatrix<std::int32_t>(width, height));
+            checkClamp(createMatrix<float>(width, height));
+            checkClamp(createMatrix<int8_t>(width, height));
+            AlignedMatrix<std::int32_t> aligned{
+                    createMatrix<std::int32_t>(width, height)};
+            checkClamp(aligned);
+        });
+}
+
+BOOST_AUTO_TEST_CASE(ClampView) {
+    Matrix<int> matrix{4, 3, 10};
+    clamp(matrixView(matrix, p11, 2, 2), 0, 5);
+    BOOST_TEST((matrix[Point{1, 1}]) == 5);
+    BOOST_TEST((matrix[Point{2, 2}]) == 5);
+    BOOST_TEST((matrix[Point{3, 1}]) == 10);
+    BOOST_TEST((matrix[Point{1, 0}]) == 10);
+}
+
+BOOST_AUTO_TEST_CASE(Transform) {
+    Matrix<int> source = createMatrix<int>(5, 3);
+    Matrix<double> destination{5, 3};
+    transform(source, destination, [](int x) { return x * 0.5; });
+    for (Point p : matrixRange(source)) {
+        BOOST_TEST(destination[p] == source[p] * 0.5);
+    }
+
+    transform(source, source, [](int x) { return x + 1; });
+    BOOST_TEST((source[p00]) == -10);
+}
+
+BOOST_AUTO_TEST_CASE(TransformIntoView) {
+    Matrix<int> source{2, 2, {1, 2, 3, 4}};
+    Matrix<int> destination{4, 4, 0};
+    transform(source, matrixView(destination, p11, 2, 2),
+            [](int x) { return x * 10; });
+    BOOST_TEST((destination[Point{1, 1}]) == 10);
+    BOOST_TEST((destination[Point{2, 2}]) == 40);
+    BOOST_TEST((destination[Point{3, 3}]) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ZipTransform) {
+    Matrix<int> source1{3, 1, {1, 2, 3}};
+    AlignedMatrix<float> source2{3, 1, {0.5, 1.5, 2.5}};
+    Matrix<float> destination{3, 1};
+    zipTransform(source1, source2, destination,
+            [](int a, float b) { return a * b; });
+    BOOST_TEST((destination[Point{0, 0}]) == 0.5);
+    BOOST_TEST((destination[Point{1, 0}]) == 3.0);
+    BOOST_TEST((destination[Point{2, 0}]) == 7.5);
+}
+
+BOOST_AUTO_TEST_CASE(CountIf) {
+    Matrix<int> matrix = createMatrix<int>(7, 4);
+    std::size_t expected = 0;
+    for (int value : matrix) {
+        expected += value % 2 == 0 ? 1 : 0;
+    }
+    BOOST_TEST(countIf(matrix, [](int x) { return x % 2 == 0; }) == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // MatrixKernelsTest
@@ -1,12 +1,50 @@
 #include "matrix/Matrix.hpp"
 #include "matrix/MatrixIO.hpp"
+#include "matrix/PmrMatrix.hpp"
 
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
+#include <boost/container/pmr/monotonic_buffer_resource.hpp>
 #include <boost/test/unit_test.hpp>
 
 using namespace util::matrix;
 
+namespace {
+
+template<typename T>
+struct CountingAllocator {
+    typedef T value_type;
+
+    std::size_t* allocations;
+
+    explicit CountingAllocator(std::size_t* allocations):
+            allocations(allocations) {}
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other):
+            allocations(other.allocations) {}
+
+    T* allocate(std::size_t n) {
+        ++*allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const CountingAllocator<U>& other) const {
+        return allocations == other.allocations;
+    }
+    template<typename U>
+    bool operator!=(const CountingAllocator<U>& other) const {
+        return allocations != other.allocations;
+    }
+};
+
+using CountingMatrix = Matrix<int, CountingAllocator<int>>;
+
+} // unnamed namespace
+
 BOOST_AUTO_TEST_SUITE(MatrixTest)
 
 BOOST_AUTO_TEST_CASE(DefaultConstruct) {
@@ -271,4 +309,70 @@ BOOST_AUTO_TEST_CASE(CopyFromConvertibleMatrixType) {
     BOOST_CHECK_EQUAL(converted, expected);
 }
 
+BOOST_AUTO_TEST_CASE(ConstructWithAllocator) {
+    std::size_t allocations = 0;
+    CountingAllocator<int> allocator{&allocations};
+    CountingMatrix matrix{3, 2, 7, allocator};
+    BOOST_TEST(allocations == 1);
+    BOOST_CHECK(matrix.get_allocator() == allocator);
+    BOOST_CHECK_EQUAL((matrix[Point{2, 1}]), 7);
+
+    CountingMatrix empty{allocator};
+    BOOST_TEST(empty.width() == 0);
+    BOOST_CHECK(empty.get_allocator() == allocator);
+}
+
+BOOST_AUTO_TEST_CASE(AllocatorIsCarried) {
+    std::size_t allocations1 = 0;
+    std::size_t allocations2 = 0;
+    CountingAllocator<int> allocator1{&allocations1};
+    CountingAllocator<int> allocator2{&allocations2};
+    CountingMatrix matrix{3, 2, {1, 2, 3, 4, 5, 6}, allocator1};
+
+    CountingMatrix copy{matrix};
+    BOOST_CHECK(copy.get_allocator() == allocator1);
+    BOOST_TEST(allocations1 == 2);
+
+    CountingMatrix otherCopy{matrix, allocator2};
+    BOOST_CHECK(otherCopy.get_allocator() == allocator2);
+    BOOST_TEST(allocations2 == 1);
+    BOOST_CHECK_EQUAL(otherCopy, matrix);
+
+    CountingMatrix moved{std::move(copy)};
+    BOOST_CHECK(moved.get_allocator() == allocator1);
+    BOOST_TEST(allocations1 == 2);
+    BOOST_TEST(copy.width() == 0);
+
+    moved.reset(10, 10, 1);
+    BOOST_CHECK(moved.get_allocator() == allocator1);
+    BOOST_TEST(allocations1 == 3);
+
+    CountingMatrix converted{Matrix<short>{2, 2, 3}, allocator2};
+    BOOST_CHECK(converted.get_allocator() == allocator2);
+    BOOST_TEST(allocations2 == 2);
+    BOOST_CHECK(converted == (Matrix<int>{2, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(PmrMatrixUsesMemoryResource) {
+    alignas(16) char buffer[1024];
+    boost::container::pmr::monotonic_buffer_resource resource{
+            buffer, sizeof(buffer)};
+    pmr::Matrix<int> matrix{4, 4, 2, &resource};
+    BOOST_TEST(static_cast<void*>(matrix.data()) >=
+            static_cast<void*>(buffer));
+    BOOST_TEST(static_cast<void*>(matrix.data() + matrix.size()) <=
+            static_cast<void*>(buffer + sizeof(buffer)));
+
+    pmr::Matrix<int> copy{matrix, &resource};
+    BOOST_CHECK(copy.get_allocator().resource() == &resource);
+    BOOST_CHECK(copy == matrix);
+    BOOST_CHECK(copy == (Matrix<int>{4, 4, 2}));
+
+    pmr::Matrix<int> assigned{&resource};
+    assigned = Matrix<int>{2, 3, 1};
+    BOOST_CHECK(assigned.get_allocator().resource() == &resource);
+    BOOST_TEST(assigned.width() == 2);
+    BOOST_TEST(assigned.height() == 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // MatrixTest
@@ -0,0 +1,123 @@
+#include "matrix/AlignedMatrix.hpp"
+#include "matrix/DumperFunctions.hpp"
+#include "matrix/MatrixView.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(MatrixViewTest)
+
+namespace {
+
+Matrix<int> createMatrix() {
+    return Matrix<int>{4, 3, {
+         0,  1,  2,  3,
+        10, 11, 12, 13,
+        20, 21, 22, 23
+    }};
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_CASE(WholeMatrix) {
+    Matrix<int> matrix = createMatrix();
+    auto view = matrixView(matrix);
+    BOOST_TEST(view.width() == 4);
+    BOOST_TEST(view.height() == 3);
+    BOOST_TEST(view.stride() == 4);
+    for (Point p : matrixRange(matrix)) {
+        BOOST_CHECK_EQUAL(view[p], matrix[p]);
+    }
+    BOOST_CHECK_EQUAL_COLLECTIONS(view.begin(), view.end(),
+            matrix.begin(), matrix.end());
+}
+
+BOOST_AUTO_TEST_CASE(SubMatrix) {
+    Matrix<int> matrix = createMatrix();
+    MatrixView<int> view{matrix, Point{1, 1}, 2, 2};
+    BOOST_TEST(view.width() == 2);
+    BOOST_TEST(view.height() == 2);
+    BOOST_CHECK_EQUAL((view[Point{0, 0}]), 11);
+    BOOST_CHECK_EQUAL((view[Point{1, 0}]), 12);
+    BOOST_CHECK_EQUAL((view[Point{0, 1}]), 21);
+    BOOST_CHECK_EQUAL((view[Point{1, 1}]), 22);
+
+    std::vector<int> expected{11, 12, 21, 22};
+    BOOST_CHECK_EQUAL_COLLECTIONS(view.begin(), view.end(),
+            expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(WriteThroughView) {
+    Matrix<int> matrix = createMatrix();
+    auto view = matrixView(matrix, Point{2, 0}, 2, 3);
+    view[Point{0, 0}] = -1;
+    for (int& value : view) {
+        value *= 2;
+    }
+    BOOST_CHECK_EQUAL((matrix[Point{2, 0}]), -2);
+    BOOST_CHECK_EQUAL((matrix[Point{3, 2}]), 46);
+    BOOST_CHECK_EQUAL((matrix[Point{1, 2}]), 21);
+
+    view.fill(5);
+    BOOST_CHECK_EQUAL((matrix[Point{2, 1}]), 5);
+    BOOST_CHECK_EQUAL((matrix[Point{1, 1}]), 11);
+}
+
+BOOST_AUTO_TEST_CASE(ConstView) {
+    const Matrix<int> matrix = createMatrix();
+    auto view = matrixView(matrix, Point{0, 1}, 3, 1);
+    static_assert(std::is_same<decltype(view), ConstMatrixView<int>>::value,
+            "View of a const matrix must be const.");
+    BOOST_CHECK_EQUAL((view[Point{2, 0}]), 12);
+
+    Matrix<int> mutableMatrix = createMatrix();
+    MatrixView<int> mutableView{mutableMatrix};
+    ConstMatrixView<int> converted = mutableView;
+    BOOST_CHECK(converted == mutableView);
+}
+
+BOOST_AUTO_TEST_CASE(SubView) {
+    Matrix<int> matrix = createMatrix();
+    auto view = matrixView(matrix, Point{1, 0}, 3, 3);
+    auto subView = view.subView(Point{1, 1}, 2, 2);
+    BOOST_CHECK_EQUAL((subView[Point{0, 0}]), 12);
+    BOOST_CHECK_EQUAL((subView[Point{1, 1}]), 23);
+}
+
+BOOST_AUTO_TEST_CASE(ViewOfAlignedMatrix) {
+    AlignedMatrix<int> matrix{createMatrix()};
+    auto view = matrixView(matrix, Point{1, 1}, 3, 2);
+    BOOST_TEST(view.stride() == matrix.stride());
+    BOOST_CHECK_EQUAL((view[Point{2, 1}]), 23);
+}
+
+BOOST_AUTO_TEST_CASE(FreeFunctions) {
+    Matrix<int> matrix = createMatrix();
+    auto view = matrixView(matrix, Point{1, 1}, 2, 2);
+    BOOST_CHECK((isInsideMatrix(view, Point{1, 1})));
+    BOOST_CHECK((!isInsideMatrix(view, Point{2, 1})));
+    BOOST_CHECK_EQUAL((matrixAt(view, Point{0, 1}, -1)), 21);
+    BOOST_CHECK_EQUAL((matrixAt(view, Point{2, 1}, -1)), -1);
+
+    int count = 0;
+    for (Point p : matrixRange(view)) {
+        BOOST_CHECK_EQUAL(view[p], matrix[p + p11]);
+        ++count;
+    }
+    BOOST_TEST(count == 4);
+}
+
+BOOST_AUTO_TEST_CASE(Dump) {
+    Matrix<int> matrix = createMatrix();
+    Matrix<int> copy{2, 2, {11, 12, 21, 22}};
+    std::ostringstream viewOutput;
+    dumpMatrix(viewOutput, matrixView(matrix, Point{1, 1}, 2, 2));
+    std::ostringstream copyOutput;
+    dumpMatrix(copyOutput, copy);
+    BOOST_TEST(viewOutput.str() == copyOutput.str());
+}
+
+BOOST_AUTO_TEST_SUITE_END() // MatrixViewTest
@@ -0,0 +1,156 @@
+#include "matrix/AlignedMatrix.hpp"
+#include "matrix/ParallelAlgorithms.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace util;
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+namespace {
+
+struct Fixture {
+    ThreadPool threadPool{4};
+    ThreadPoolRunner runner{threadPool};
+};
+
+} // unnamed namespace
+
+BOOST_FIXTURE_TEST_SUITE(ParallelAlgorithmsTest, Fixture)
+
+BOOST_AUTO_TEST_CASE(ForBandsCoversRange) {
+    for (std::size_t grain : {0, 1, 3, 7, 100}) {
+        std::vector<std::atomic<int>> visited(50);
+        parallelForBands(threadPool, visited.size(), grain,
+                [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; ++i) {
+                        ++visited[i];
+                    }
+                });
+        for (const auto& value : visited) {
+            BOOST_TEST_REQUIRE(value == 1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ForBandsUsesThreads) {
+    std::atomic<int> onPoolThread{0};
+    parallelForBands(threadPool, 8, 1,
+            [&](std::size_t, std::size_t) {
+                if (ThreadPool::getCurrentThreadId()) {
+                    ++onPoolThread;
+                }
+            });
+    BOOST_TEST(onPoolThread == 8);
+}
+
+BOOST_AUTO_TEST_CASE(ForBandsPropagatesException) {
+    std::atomic<int> finished{0};
+    BOOST_CHECK_THROW(parallelForBands(threadPool, 10, 1,
+            [&](std::size_t begin, std::size_t) {
+                if (begin == 3) {
+                    throw std::runtime_error{"band failed"};
+                }
+                ++finished;
+            }), std::runtime_error);
+    BOOST_TEST(finished == 9);
+}
+
+BOOST_AUTO_TEST_CASE(NestedCallRunsInline) {
+    std::atomic<int> count{0};
+    parallelForBands(threadPool, 4, 1,
+            [&](std::size_t, std::size_t) {
+                parallelForBands(threadPool, 4, 1,
+                        [&](std::size_t, std::size_t) { ++count; });
+            });
+    BOOST_TEST(count == 16);
+}
+
+BOOST_AUTO_TEST_CASE(Transform) {
+    Matrix<int> source = createMatrix(13, 21);
+    Matrix<double> destination{13, 21};
+    parallelTransform(threadPool, source, destination,
+            [](int x) { return x * 0.5; }, 2);
+    for (Point p : matrixRange(source)) {
+        BOOST_TEST_REQUIRE(destination[p] == source[p] * 0.5);
+    }
+
+    AlignedMatrix<int> aligned{13, 21};
+    parallelTransform(threadPool, source, aligned,
+            [](int x) { return x + 1; });
+    for (Point p : matrixRange(source)) {
+        BOOST_TEST_REQUIRE(aligned[p] == source[p] + 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Reduce) {
+    Matrix<int> matrix = createMatrix(17, 33);
+    long expected = 0;
+    for (int value : matrix) {
+        expected += value;
+    }
+    for (std::size_t grain : {0, 1, 5, 33, 40}) {
+        BOOST_TEST(parallelReduce(threadPool, matrix, 0L,
+                [](long sum, int value) { return sum + value; },
+                [](long lhs, long rhs) { return lhs + rhs; },
+                grain) == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ReduceIsDeterministic) {
+    Matrix<int> matrix = createMatrix(5, 20);
+    std::string expected;
+    for (int value : matrix) {
+        expected += std::to_string(value) + ",";
+    }
+    for (int i = 0; i < 10; ++i) {
+        BOOST_TEST(parallelReduce(threadPool, matrix, std::string{},
+                [](std::string result, int value) {
+                    std::this_thread::yield();
+                    return result + std::to_string(value) + ",";
+                },
+                [](std::string lhs, const std::string& rhs) {
+                    return lhs + rhs;
+                }, 3) == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ForEachPoint) {
+    Matrix<int> matrix = createMatrix(9, 14);
+    Matrix<int> result{9, 14, 0};
+    parallelForEachPoint(threadPool, matrix,
+            [&](Point p) { result[p] += matrix[p] * 2; });
+    for (Point p : matrixRange(matrix)) {
+        BOOST_TEST_REQUIRE(result[p] == matrix[p] * 2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(StoppedPoolRunsInline) {
+    ThreadPool stoppedPool{2};
+    Matrix<int> matrix = createMatrix(4, 6);
+    std::atomic<int> count{0};
+    parallelForEachPoint(stoppedPool, matrix,
+            [&](Point) {
+                BOOST_TEST(ThreadPool::getCurrentThreadId() == nullptr);
+                ++count;
+            }, 1);
+    BOOST_TEST(count == 24);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyMatrix) {
+    Matrix<int> matrix;
+    BOOST_TEST(parallelReduce(threadPool, matrix, 5,
+            [](int sum, int value) { return sum + value; },
+            [](int lhs, int rhs) { return lhs + rhs; }) == 5);
+    parallelForEachPoint(threadPool, Matrix<int>{0, 5},
+            [](Point) { BOOST_FAIL("unexpected call"); });
+}
+
+BOOST_AUTO_TEST_SUITE_END() // ParallelAlgorithmsTest
@@ -0,0 +1,127 @@
+#include "matrix/BitMatrix.hpp"
+#include "matrix/GridSearcher.hpp"
+#include "matrix/ParallelBfs.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace util;
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+namespace {
+
+template<typename Neighborhood>
+Matrix<int> searchSequentially(const Matrix<bool>& map,
+        const std::vector<Point>& sources) {
+    Matrix<int> result{map.width(), map.height(), -1};
+    GridSearcher<Neighborhood> searcher{map.width(), map.height()};
+    searcher.bfs(sources, [&map](Point p) { return map[p]; },
+            [&result](Point p, int distance) {
+                result[p] = distance;
+                return true;
+            });
+    return result;
+}
+
+template<typename Neighborhood>
+void checkParents(const ParallelBfsResult& result) {
+    for (Point p : matrixRange(result.distances)) {
+        int distance = result.distances[p];
+        std::uint8_t parent = result.parents[p];
+        if (distance <= 0) {
+            BOOST_TEST_REQUIRE(parent == noBfsParent);
+            continue;
+        }
+        BOOST_TEST_REQUIRE(parent < std::size_t{Neighborhood::size});
+        Point q = p + Neighborhood{}.offsets(p)[parent];
+        BOOST_TEST_REQUIRE(isInsideMatrix(result.distances, q));
+        BOOST_TEST_REQUIRE(result.distances[q] == distance - 1);
+    }
+}
+
+const std::vector<ParallelBfsOptions> optionSets{
+        ParallelBfsOptions{true, 14, 24},
+        // Top-down only.
+        ParallelBfsOptions{true, 0, 24},
+        // Bottom-up after the first level.
+        ParallelBfsOptions{true, 1000000, 0},
+        ParallelBfsOptions{false, 14, 24}};
+
+template<typename Neighborhood>
+void checkRandomMaps() {
+    ThreadPool threadPool{4};
+    ThreadPoolRunner runner{threadPool};
+    for (Point size : {Point{1, 1}, Point{7, 1}, Point{1, 9},
+            Point{40, 30}, Point{130, 70}}) {
+        for (unsigned walls : {0u, 20u, 45u}) {
+            Matrix<bool> map = createRandomMap(size.x, size.y, walls + 1,
+                    walls);
+            std::vector<Point> sources{Point{size.x / 2, size.y / 2},
+                    Point{0, size.y - 1}, Point{size.x - 1, 0}, p00, p00};
+            Matrix<int> expected =
+                    searchSequentially<Neighborhood>(map, sources);
+            for (const auto& options : optionSets) {
+                BOOST_TEST_CONTEXT("size " << size << " walls " << walls
+                        << " alpha " << options.alpha << " beta "
+                        << options.beta) {
+                    auto result = parallelBfs(threadPool, map, sources,
+                            Neighborhood{}, options);
+                    BOOST_TEST(result.distances == expected);
+                    if (options.parents) {
+                        checkParents<Neighborhood>(result);
+                    } else {
+                        BOOST_TEST(result.parents.size() == 0u);
+                    }
+                    BOOST_TEST(parallelBfs(threadPool, BitMatrix{map},
+                            sources, Neighborhood{}, options).distances ==
+                            expected);
+                }
+            }
+        }
+    }
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(ParallelBfsTest)
+
+BOOST_AUTO_TEST_CASE(Square) {
+    checkRandomMaps<SquareNeighborhood>();
+}
+
+BOOST_AUTO_TEST_CASE(Diagonal) {
+    checkRandomMaps<SquareDiagonalNeighborhood>();
+}
+
+BOOST_AUTO_TEST_CASE(Hex) {
+    checkRandomMaps<HexNeighborhood>();
+}
+
+BOOST_AUTO_TEST_CASE(ImpassableSource) {
+    ThreadPool threadPool{2};
+    ThreadPoolRunner runner{threadPool};
+    Matrix<bool> map{3, 1, true};
+    map[p10] = false;
+    auto result = parallelBfs(threadPool, map, {p10});
+    BOOST_TEST(result.distances == (Matrix<int>{3, 1, {1, 0, 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(NoSources) {
+    ThreadPool threadPool{2};
+    ThreadPoolRunner runner{threadPool};
+    auto result = parallelBfs(threadPool, Matrix<bool>{4, 3, true}, {});
+    BOOST_TEST(result.distances == (Matrix<int>{4, 3, -1}));
+}
+
+BOOST_AUTO_TEST_CASE(PoolNotRunning) {
+    ThreadPool threadPool{2};
+    Matrix<bool> map = createRandomMap(50, 40, 3, 30);
+    std::vector<Point> sources{Point{25, 20}};
+    BOOST_TEST(parallelBfs(threadPool, map, sources,
+            SquareDiagonalNeighborhood{}).distances ==
+            searchSequentially<SquareDiagonalNeighborhood>(map, sources));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // ParallelBfsTest
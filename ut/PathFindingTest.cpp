@@ -0,0 +1,244 @@
+#include "matrix/PathFinding.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/optional/optional_io.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <deque>
+#include <functional>
+#include <queue>
+#include <thread>
+
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+namespace {
+
+template<typename Cost>
+Matrix<Cost> createCosts(std::size_t width, std::size_t height,
+        unsigned seed) {
+    return createRandomMatrix<Cost>(width, height, seed,
+            [](unsigned value) {
+                value %= 10;
+                return value < 2 ?
+                        PathFinder<SquareNeighborhood, Cost>::impassable :
+                        static_cast<Cost>(value - 1);
+            });
+}
+
+// Dijkstra's algorithm with std::priority_queue.
+template<typename Neighborhood, typename Cost>
+Matrix<Cost> findAllNaively(const Matrix<Cost>& costs,
+        const Neighborhood& neighborhood, Point start, bool checkCorners) {
+    const Cost impassable = PathFinder<Neighborhood, Cost>::impassable;
+    Matrix<Cost> result{costs.width(), costs.height(), impassable};
+    typedef std::pair<Cost, Point> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    result[start] = 0;
+    queue.emplace(0, start);
+    while (!queue.empty()) {
+        Entry entry = queue.top();
+        queue.pop();
+        Point p = entry.second;
+        if (entry.first != result[p]) {
+            continue;
+        }
+        for (Point offset : neighborhood.offsets(p)) {
+            Point q = p + offset;
+            if (!isInsideMatrix(costs, q) || costs[q] == impassable) {
+                continue;
+            }
+            if (checkCorners && offset.x != 0 && offset.y != 0 &&
+                    (costs[Point{q.x, p.y}] == impassable ||
+                     costs[Point{p.x, q.y}] == impassable)) {
+                continue;
+            }
+            Cost cost = result[p] + costs[q];
+            if (cost < result[q]) {
+                result[q] = cost;
+                queue.emplace(cost, q);
+            }
+        }
+    }
+    return result;
+}
+
+template<typename Neighborhood, typename Cost>
+void checkPath(const PathFinder<Neighborhood, Cost>& pathFinder,
+        const Matrix<Cost>& costs, const Neighborhood& neighborhood,
+        Point start, Point goal, Cost expectedCost) {
+    std::vector<Point> path = pathFinder.path(goal);
+    std::vector<std::size_t> directions = pathFinder.directions(goal);
+    BOOST_TEST_REQUIRE(!path.empty());
+    BOOST_TEST(path.front() == start);
+    BOOST_TEST(path.back() == goal);
+    BOOST_TEST_REQUIRE(directions.size() == path.size() - 1);
+    Cost cost = 0;
+    for (std::size_t i = 1; i < path.size(); ++i) {
+        BOOST_TEST((path[i - 1] + neighborhood.offsets(path[i - 1])[
+                directions[i - 1]]) == path[i]);
+        cost += costs[path[i]];
+    }
+    BOOST_TEST(cost == expectedCost);
+}
+
+template<typename Neighborhood, typename Cost>
+void checkFindPath(const Neighborhood& neighborhood, bool checkCorners,
+        Cost maxCellCost, Cost heuristicWeight) {
+    PathFinder<Neighborhood, Cost> pathFinder{neighborhood};
+    pathFinder.setMaxCellCost(maxCellCost);
+    pathFinder.setHeuristicWeight(heuristicWeight);
+    for (unsigned seed = 0; seed < 5; ++seed) {
+        Matrix<Cost> costs = createCosts<Cost>(17, 13, seed);
+        Point start{static_cast<int>(seed), static_cast<int>(seed)};
+        costs[start] = 1;
+        auto expected = findAllNaively(costs, neighborhood, start,
+                checkCorners);
+        for (Point goal : matrixRange(costs)) {
+            BOOST_TEST_CONTEXT("seed " << seed << " goal " << goal) {
+                auto result = pathFinder.findPath(costs, start, goal);
+                if (expected[goal] ==
+                        PathFinder<Neighborhood, Cost>::impassable) {
+                    BOOST_TEST(!result);
+                    BOOST_TEST(pathFinder.path(goal).empty());
+                } else {
+                    BOOST_TEST_REQUIRE(!!result);
+                    BOOST_TEST(*result == expected[goal]);
+                    checkPath(pathFinder, costs, neighborhood, start, goal,
+                            expected[goal]);
+                }
+            }
+        }
+    }
+}
+
+template<typename Neighborhood>
+void checkAll(const Neighborhood& neighborhood, bool checkCorners) {
+    // Bucket queue.
+    checkFindPath<Neighborhood, int>(neighborhood, checkCorners, 8, 1);
+    // Radix heap.
+    checkFindPath<Neighborhood, int>(neighborhood, checkCorners, 0, 1);
+    checkFindPath<Neighborhood, unsigned>(neighborhood, checkCorners, 0, 0);
+    // Binary heap.
+    checkFindPath<Neighborhood, double>(neighborhood, checkCorners, 0, 1.0);
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(PathFindingTest)
+
+BOOST_AUTO_TEST_CASE(HexDistance) {
+    Matrix<int> distances{9, 9, -1};
+    Point start{4, 4};
+    std::deque<Point> queue{start};
+    distances[start] = 0;
+    while (!queue.empty()) {
+        Point p = queue.front();
+        queue.pop_front();
+        for (Point offset : HexNeighborhood{}.offsets(p)) {
+            Point q = p + offset;
+            if (isInsideMatrix(distances, q) && distances[q] < 0) {
+                distances[q] = distances[p] + 1;
+                queue.push_back(q);
+            }
+        }
+    }
+    for (Point p : matrixRange(distances)) {
+        BOOST_TEST(hex::distance(start, p) == distances[p]);
+        BOOST_TEST(hex::distance(p, start) == distances[p]);
+        BOOST_TEST(hex::distance(p - Point{10, 4}, start - Point{10, 4}) ==
+                distances[p]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ChebyshevDistance) {
+    BOOST_TEST(chebyshevDistance(p00, Point{3, -5}) == 5);
+    BOOST_TEST(chebyshevDistance(Point{-2, 1}, Point{2, 2}) == 4);
+}
+
+BOOST_AUTO_TEST_CASE(Square) {
+    checkAll(SquareNeighborhood{}, false);
+}
+
+BOOST_AUTO_TEST_CASE(SquareDiagonal) {
+    checkAll(SquareDiagonalNeighborhood{}, true);
+}
+
+BOOST_AUTO_TEST_CASE(Hex) {
+    checkAll(HexNeighborhood{}, false);
+}
+
+BOOST_AUTO_TEST_CASE(NoCornerCutting) {
+    const int x = PathFinder<SquareDiagonalNeighborhood>::impassable;
+    Matrix<int> costs{3, 3, {
+            1, x, 1,
+            1, 1, 1,
+            1, 1, 1}};
+    PathFinder<SquareDiagonalNeighborhood> pathFinder;
+    auto result = pathFinder.findPath(costs, p00, Point{2, 0});
+    BOOST_TEST_REQUIRE(!!result);
+    BOOST_TEST(*result == 4);
+    BOOST_TEST(pathFinder.path(Point{2, 0}).size() == 5u);
+}
+
+BOOST_AUTO_TEST_CASE(Directions) {
+    Matrix<int> costs{4, 3, 1};
+    PathFinder<SquareNeighborhood> pathFinder;
+    auto result = pathFinder.findPath(costs, p00, p00);
+    BOOST_TEST_REQUIRE(!!result);
+    BOOST_TEST(*result == 0);
+    BOOST_TEST(pathFinder.path(p00) == std::vector<Point>{p00});
+    BOOST_TEST(pathFinder.directions(p00).empty());
+
+    costs[Point{1, 0}] = PathFinder<SquareNeighborhood>::impassable;
+    costs[Point{1, 1}] = PathFinder<SquareNeighborhood>::impassable;
+    result = pathFinder.findPath(costs, p00, Point{2, 0});
+    BOOST_TEST_REQUIRE(!!result);
+    BOOST_TEST(*result == 6);
+    std::vector<std::size_t> expected{
+            static_cast<std::size_t>(square::Direction::down),
+            static_cast<std::size_t>(square::Direction::down),
+            static_cast<std::size_t>(square::Direction::right),
+            static_cast<std::size_t>(square::Direction::right),
+            static_cast<std::size_t>(square::Direction::up),
+            static_cast<std::size_t>(square::Direction::up)};
+    BOOST_TEST(pathFinder.directions(Point{2, 0}) == expected,
+            boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(FindAll) {
+    Matrix<int> costs = createCosts<int>(20, 20, 7);
+    costs[p00] = 1;
+    PathFinder<HexNeighborhood> pathFinder;
+    pathFinder.setMaxCellCost(8);
+    pathFinder.findAll(costs, p00);
+    auto expected = findAllNaively(costs, HexNeighborhood{}, p00, false);
+    for (Point p : matrixRange(costs)) {
+        if (expected[p] == PathFinder<HexNeighborhood>::impassable) {
+            BOOST_TEST(!pathFinder.isSettled(p));
+        } else {
+            BOOST_TEST(pathFinder.cost(p) == expected[p]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ResizesToCosts) {
+    PathFinder<SquareNeighborhood> pathFinder;
+    BOOST_TEST(pathFinder.findPath(Matrix<int>{3, 3, 2}, p00, p11) == 4);
+    BOOST_TEST(pathFinder.findPath(Matrix<int>{7, 2, 1}, p00, Point{6, 1}) ==
+            7);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadLocal) {
+    auto* pathFinder = &threadLocalPathFinder<SquareNeighborhood>();
+    BOOST_TEST(pathFinder == &threadLocalPathFinder<SquareNeighborhood>());
+    PathFinder<SquareNeighborhood>* otherPathFinder = nullptr;
+    std::thread thread{[&otherPathFinder]() {
+            otherPathFinder = &threadLocalPathFinder<SquareNeighborhood>();
+        }};
+    thread.join();
+    BOOST_TEST(pathFinder != otherPathFinder);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // PathFindingTest
@@ -0,0 +1,125 @@
+#include "matrix/MatrixIO.hpp"
+#include "matrix/PersistentMatrix.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+BOOST_AUTO_TEST_SUITE(PersistentMatrixTest)
+
+BOOST_AUTO_TEST_CASE(Construct) {
+    PersistentMatrix<int, 4> matrix{10, 5, 3};
+    BOOST_TEST(matrix.width() == 10);
+    BOOST_TEST(matrix.height() == 5);
+    BOOST_TEST(matrix.tileCount() == 6);
+    BOOST_TEST(matrix.sharedTileCount() == 6);
+    BOOST_TEST((matrix[Point{9, 4}]) == 3);
+}
+
+BOOST_AUTO_TEST_CASE(ConvertMatrix) {
+    Matrix<int> source = createMatrix(11, 7);
+    PersistentMatrix<int, 4> matrix{source};
+    BOOST_TEST(matrix.sharedTileCount() == 0);
+    for (Point p : matrixRange(source)) {
+        BOOST_TEST_REQUIRE(matrix[p] == source[p]);
+    }
+    BOOST_CHECK_EQUAL(matrix.toMatrix(), source);
+}
+
+BOOST_AUTO_TEST_CASE(CopyOnWrite) {
+    const Matrix<int> source = createMatrix(8, 8);
+    PersistentMatrix<int, 4> matrix{source};
+    PersistentMatrix<int, 4> copy = matrix;
+    BOOST_TEST(matrix.sharedTileCount() == 4);
+
+    copy[Point{5, 1}] = 100;
+    BOOST_TEST(matrix.sharedTileCount() == 3);
+    BOOST_TEST((copy[Point{5, 1}]) == 100);
+    BOOST_TEST((matrix[Point{5, 1}]) == (source[Point{5, 1}]));
+    BOOST_TEST((copy[Point{6, 1}]) == (source[Point{6, 1}]));
+
+    copy[Point{6, 1}] = 200;
+    BOOST_TEST(matrix.sharedTileCount() == 3);
+    BOOST_TEST((matrix[Point{6, 1}]) == (source[Point{6, 1}]));
+    BOOST_CHECK(matrix != copy);
+
+    copy[Point{5, 1}] = source[Point{5, 1}];
+    copy[Point{6, 1}] = source[Point{6, 1}];
+    BOOST_CHECK(matrix == copy);
+}
+
+BOOST_AUTO_TEST_CASE(WriteToDefaultTile) {
+    PersistentMatrix<int, 4> matrix{8, 8, 0};
+    matrix[Point{0, 0}] = 1;
+    BOOST_TEST(matrix.sharedTileCount() == 3);
+    BOOST_TEST((matrix[Point{0, 0}]) == 1);
+    BOOST_TEST((matrix[Point{4, 0}]) == 0);
+    BOOST_TEST((matrix[Point{0, 4}]) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ManyCopies) {
+    PersistentMatrix<int> base{createMatrix(64, 64)};
+    std::vector<PersistentMatrix<int>> children(100, base);
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        children[i][Point(i % 64, i / 64)] += 1;
+    }
+    for (std::size_t i = 0; i < children.size(); ++i) {
+        Matrix<int> expected = createMatrix(64, 64);
+        expected[Point(i % 64, i / 64)] += 1;
+        BOOST_CHECK_EQUAL(children[i].toMatrix(), expected);
+    }
+    BOOST_CHECK_EQUAL(base.toMatrix(), createMatrix(64, 64));
+}
+
+BOOST_AUTO_TEST_CASE(CopiesInThreads) {
+    const Matrix<int> expected = createMatrix(32, 32);
+    std::vector<PersistentMatrix<int, 8>> copies(4,
+            PersistentMatrix<int, 8>{expected});
+    std::vector<int> sums(copies.size(), 0);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < copies.size(); ++i) {
+        threads.emplace_back([&copies, &sums, i]() {
+                PersistentMatrix<int, 8> copy = std::move(copies[i]);
+                for (Point p : matrixRange(copy)) {
+                    sums[i] += copy[p];
+                    copy[p] = -1;
+                }
+            });
+    }
+    int expectedSum = 0;
+    for (int value : expected) {
+        expectedSum += value;
+    }
+    for (std::size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+        BOOST_TEST(sums[i] == expectedSum);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Bool) {
+    PersistentMatrix<bool, 4> matrix{6, 6, false};
+    matrix.set(Point{5, 1}, true);
+    const auto& constMatrix = matrix;
+    bool value = constMatrix[Point{5, 1}];
+    BOOST_TEST(value);
+    value = constMatrix[Point{4, 1}];
+    BOOST_TEST(!value);
+}
+
+BOOST_AUTO_TEST_CASE(FillAndReset) {
+    PersistentMatrix<int, 4> matrix{createMatrix(5, 5)};
+    matrix.fill(7);
+    BOOST_CHECK_EQUAL(matrix.toMatrix(), (Matrix<int>{5, 5, 7}));
+    matrix.reset(9, 2, 1);
+    BOOST_CHECK_EQUAL(matrix.toMatrix(), (Matrix<int>{9, 2, 1}));
+    matrix.clear();
+    BOOST_TEST(matrix.size() == 0);
+    BOOST_TEST(matrix.tileCount() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // PersistentMatrixTest
@@ -27,6 +27,25 @@ BOOST_AUTO_TEST_CASE(EmptyRange)
     BOOST_CHECK_THROW(range.back(), std::out_of_range);
 }
 
+BOOST_AUTO_TEST_CASE(ZeroWidthOrHeightRange)
+{
+    PointRange zeroWidth(Point(2, 1), Point(2, 5));
+    BOOST_CHECK(zeroWidth.empty());
+    BOOST_CHECK(zeroWidth.begin() == zeroWidth.end());
+    BOOST_CHECK_THROW(zeroWidth.front(), std::out_of_range);
+    PointRange zeroHeight(Point(2, 1), Point(6, 1));
+    BOOST_CHECK(zeroHeight.empty());
+    BOOST_CHECK(zeroHeight.begin() == zeroHeight.end());
+}
+
+BOOST_AUTO_TEST_CASE(Accessors)
+{
+    PointRange range(Point(-2, 1), Point(3, 4));
+    BOOST_CHECK_EQUAL(range.beginPoint(), Point(-2, 1));
+    BOOST_CHECK_EQUAL(range.endPoint(), Point(3, 4));
+    BOOST_CHECK(!range.empty());
+}
+
 
 BOOST_AUTO_TEST_CASE(SinglePointRange)
 {
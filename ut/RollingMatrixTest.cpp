@@ -0,0 +1,113 @@
+#include "matrix/RollingMatrix.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <vector>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(RollingMatrixTest)
+
+BOOST_AUTO_TEST_CASE(PushRows) {
+    RollingMatrix<int> matrix{3, 2, -1};
+    BOOST_TEST(matrix.rowCount() == 0);
+    BOOST_TEST(!matrix.contains(0));
+
+    matrix.pushRow(std::vector<int>{1, 2, 3});
+    matrix.pushRow(std::vector<int>{4, 5});
+    BOOST_TEST(matrix.firstRow() == 0);
+    BOOST_TEST(matrix.endRow() == 2);
+    BOOST_TEST((matrix[Point{2, 0}]) == 3);
+    BOOST_TEST((matrix[Point{1, 1}]) == 5);
+    BOOST_TEST((matrix[Point{2, 1}]) == -1);
+
+    matrix.pushRow(std::vector<int>{7, 8, 9});
+    BOOST_TEST(matrix.rowCount() == 2);
+    BOOST_TEST(matrix.firstRow() == 1);
+    BOOST_TEST(!matrix.contains(0));
+    BOOST_TEST((matrix[Point{0, 1}]) == 4);
+    BOOST_TEST((matrix[Point{0, 2}]) == 7);
+    BOOST_TEST(matrix.row(2)[2] == 9);
+}
+
+BOOST_AUTO_TEST_CASE(PushTooLongRow) {
+    RollingMatrix<int> matrix{3, 2, -1};
+    matrix.pushRow(std::vector<int>{1, 2, 3});
+    matrix.pushRow(std::vector<int>{4, 5, 6, 7, 8, 9, 10});
+    BOOST_TEST(matrix.row(0)[0] == 1);
+    BOOST_TEST(matrix.row(1)[2] == 6);
+    // The last slot of the ring buffer.
+    matrix.pushRow(std::vector<int>{11, 12, 13, 14});
+    matrix.pushRow(std::vector<int>{15, 16, 17, 18});
+    BOOST_TEST(matrix.row(2)[2] == 13);
+    BOOST_TEST(matrix.row(3)[0] == 15);
+    BOOST_TEST(matrix.row(3)[2] == 17);
+}
+
+BOOST_AUTO_TEST_CASE(Advance) {
+    RollingMatrix<int> matrix{2, 3};
+    int* row = matrix.advance();
+    row[1] = 6;
+    matrix[Point{0, 0}] = 5;
+    BOOST_TEST(matrix.row(0)[0] == 5);
+    BOOST_TEST(matrix.row(0)[1] == 6);
+    matrix.advance();
+    matrix.advance();
+    matrix.advance();
+    BOOST_TEST(matrix.firstRow() == 1);
+    BOOST_TEST((matrix[Point{0, 3}]) == 0);
+    matrix.clear();
+    BOOST_TEST(matrix.endRow() == 0);
+    BOOST_TEST(matrix.rowCount() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(LoadRows) {
+    std::istringstream ss{"abc\nde\nfgh\n\nijk\n"};
+    RollingMatrix<char> matrix{3, 2, '.'};
+    BOOST_TEST(matrix.loadRow(ss));
+    BOOST_TEST(matrix.loadRow(ss));
+    BOOST_TEST(matrix.loadRow(ss));
+    BOOST_TEST(!matrix.loadRow(ss));
+    BOOST_TEST(matrix.endRow() == 3);
+    BOOST_TEST((matrix[Point{2, 1}]) == '.');
+    BOOST_TEST((matrix[Point{1, 2}]) == 'g');
+}
+
+// A 3x3 box filter computed while streaming the rows in, compared with the
+// same filter on the whole matrix.
+BOOST_AUTO_TEST_CASE(StreamingFilter) {
+    const std::size_t width = 7;
+    const std::size_t height = 11;
+    std::ostringstream input;
+    Matrix<int> whole{width, height};
+    for (Point p : matrixRange(whole)) {
+        whole[p] = (p.x * 5 + p.y * 3) % 10;
+        input << whole[p] << (p.x == width - 1 ? "\n" : " ");
+    }
+
+    auto filter = [](const auto& matrix, Point p) {
+        int sum = 0;
+        for (Point d : PointRange{Point{-1, -1}, Point{2, 2}}) {
+            sum += matrix[p + d];
+        }
+        return sum;
+    };
+
+    std::istringstream is{input.str()};
+    RollingMatrix<int> rolling{width, 3};
+    int checked = 0;
+    while (rolling.loadRow(is)) {
+        if (rolling.rowCount() < 3) {
+            continue;
+        }
+        Point p{0, rolling.endRow() - 2};
+        for (p.x = 1; p.x < static_cast<int>(width) - 1; ++p.x) {
+            BOOST_TEST_REQUIRE(filter(rolling, p) == filter(whole, p));
+            ++checked;
+        }
+    }
+    BOOST_TEST(checked == static_cast<int>((width - 2) * (height - 2)));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // RollingMatrixTest
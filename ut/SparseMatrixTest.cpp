@@ -0,0 +1,143 @@
+#include "matrix/MatrixIO.hpp"
+#include "matrix/SparseMatrix.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(SparseMatrixTest)
+
+BOOST_AUTO_TEST_CASE(HugeMatrix) {
+    SparseMatrix<int> matrix{1000000, 1000000, -1};
+    BOOST_TEST(matrix.width() == 1000000);
+    BOOST_TEST(matrix.chunkCount() == 0);
+    const auto& constMatrix = matrix;
+    BOOST_TEST((constMatrix[Point{999999, 999999}]) == -1);
+    BOOST_TEST(matrix.get(Point{500000, 3}) == -1);
+    BOOST_TEST(matrix.chunkCount() == 0);
+
+    matrix[Point{999999, 999999}] = 5;
+    matrix[Point{999998, 999990}] = 6;
+    matrix[Point{0, 0}] = 7;
+    BOOST_TEST(matrix.chunkCount() == 2);
+    BOOST_TEST((constMatrix[Point{999999, 999999}]) == 5);
+    BOOST_TEST((constMatrix[Point{999998, 999990}]) == 6);
+    BOOST_TEST((constMatrix[Point{999997, 999990}]) == -1);
+    BOOST_TEST((matrixAt(matrix, Point{0, 0}, 0)) == 7);
+    BOOST_TEST((matrixAt(matrix, Point{-1, 0}, 0)) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ForEachChunk) {
+    SparseMatrix<int, 4> matrix{100, 100};
+    matrix[Point{1, 1}] = 1;
+    matrix[Point{9, 2}] = 2;
+    matrix[Point{10, 3}] = 3;
+    std::set<Point> origins;
+    int sum = 0;
+    matrix.forEachChunk([&](Point origin, const Matrix<int>& chunk) {
+                BOOST_TEST(chunk.width() == 4);
+                BOOST_TEST(chunk.height() == 4);
+                origins.insert(origin);
+                for (int value : chunk) {
+                    sum += value;
+                }
+            });
+    BOOST_TEST((origins == std::set<Point>{Point{0, 0}, Point{8, 0}}));
+    BOOST_TEST(sum == 6);
+}
+
+BOOST_AUTO_TEST_CASE(Compact) {
+    SparseMatrix<int, 4> matrix{100, 100};
+    matrix[Point{1, 1}] = 1;
+    matrix[Point{50, 50}] = 2;
+    matrix[Point{50, 50}] = 0;
+    // Reading through the non-const operator allocates.
+    int value = matrix[Point{90, 90}];
+    BOOST_TEST(value == 0);
+    BOOST_TEST(matrix.chunkCount() == 3);
+    matrix.compact();
+    BOOST_TEST(matrix.chunkCount() == 1);
+    BOOST_TEST(matrix.get(Point{1, 1}) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(ToMatrix) {
+    SparseMatrix<int, 4> matrix{6, 5, 9};
+    matrix[Point{5, 4}] = 1;
+    matrix[Point{0, 2}] = 2;
+    Matrix<int> expected{6, 5, 9};
+    expected[Point{5, 4}] = 1;
+    expected[Point{0, 2}] = 2;
+    BOOST_CHECK_EQUAL(matrix.toMatrix(), expected);
+}
+
+BOOST_AUTO_TEST_CASE(Equality) {
+    SparseMatrix<int, 4> matrix1{20, 20};
+    SparseMatrix<int, 4> matrix2{20, 20};
+    matrix1[Point{3, 3}] = 1;
+    BOOST_CHECK(matrix1 != matrix2);
+    matrix2[Point{3, 3}] = 1;
+    BOOST_CHECK(matrix1 == matrix2);
+    matrix2[Point{15, 15}] = 0;
+    BOOST_CHECK(matrix1 == matrix2);
+    BOOST_CHECK(matrix1 != (SparseMatrix<int, 4>{20, 21}));
+
+    SparseMatrix<int, 4> matrix3{2, 2, 1};
+    SparseMatrix<int, 4> matrix4{2, 2, 0};
+    BOOST_CHECK(matrix3 != matrix4);
+    for (Point p : matrixRange(matrix4)) {
+        matrix4[p] = 1;
+    }
+    BOOST_CHECK(matrix3 == matrix4);
+}
+
+BOOST_AUTO_TEST_CASE(EqualityWithDifferentDefaultsOnHugeMatrix) {
+    SparseMatrix<int, 4> matrix1{1000000, 1000000, 1};
+    SparseMatrix<int, 4> matrix2{1000000, 1000000, 0};
+    BOOST_CHECK(matrix1 != matrix2);
+    matrix1[Point{5, 5}] = 0;
+    BOOST_CHECK(matrix1 != matrix2);
+    BOOST_CHECK(matrix2 != matrix1);
+
+    // Every cell is in a chunk of either side: columns 0-3 of matrix3 and
+    // columns 4-5 of matrix4.
+    SparseMatrix<int, 4> matrix3{6, 3, 1};
+    SparseMatrix<int, 4> matrix4{6, 3, 0};
+    for (Point p : matrixRange(matrix3)) {
+        if (p.x < 4) {
+            matrix3[p] = 0;
+        } else {
+            matrix4[p] = 1;
+        }
+    }
+    BOOST_CHECK(matrix3 == matrix4);
+    BOOST_CHECK(matrix4 == matrix3);
+    matrix4[Point{5, 2}] = 2;
+    BOOST_CHECK(matrix3 != matrix4);
+}
+
+BOOST_AUTO_TEST_CASE(Bool) {
+    SparseMatrix<bool, 4> matrix{1000, 1000, true};
+    const auto& constMatrix = matrix;
+    matrix[Point{10, 20}] = false;
+    bool value = constMatrix[Point{10, 20}];
+    BOOST_TEST(!value);
+    value = constMatrix.get(Point{11, 20});
+    BOOST_TEST(value);
+    value = constMatrix[Point{500, 500}];
+    BOOST_TEST(value);
+    BOOST_TEST(matrix.chunkCount() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(Reset) {
+    SparseMatrix<int, 4> matrix{10, 10};
+    matrix[Point{1, 1}] = 1;
+    matrix.reset(5, 5, 3);
+    BOOST_TEST(matrix.chunkCount() == 0);
+    BOOST_TEST(matrix.get(Point{1, 1}) == 3);
+    matrix.clear();
+    BOOST_TEST(matrix.size() == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // SparseMatrixTest
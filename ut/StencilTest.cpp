@@ -0,0 +1,152 @@
+#include "matrix/AlignedMatrix.hpp"
+#include "matrix/Stencil.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+namespace {
+
+const std::vector<BorderMode> borderModes{
+        BorderMode::clamp, BorderMode::constant, BorderMode::wrap};
+
+// Straightforward per-point implementation to compare against.
+template<typename Neighborhood, typename Kernel>
+auto applyStencilNaively(const Matrix<int>& input,
+        const Neighborhood& neighborhood, Kernel kernel, BorderMode border,
+        int borderValue) {
+    using Result = decltype(kernel(0, std::array<int, Neighborhood::size>{}));
+    Matrix<Result> result{input.width(), input.height()};
+    int width = input.width();
+    int height = input.height();
+    for (Point p : matrixRange(input)) {
+        std::array<int, Neighborhood::size> values;
+        for (std::size_t i = 0; i < Neighborhood::size; ++i) {
+            Point q = p + neighborhood.offsets(p)[i];
+            if (isInsideMatrix(input, q)) {
+                values[i] = input[q];
+            } else if (border == BorderMode::constant) {
+                values[i] = borderValue;
+            } else if (border == BorderMode::clamp) {
+                values[i] = input[Point{
+                        std::min(std::max(q.x, 0), width - 1),
+                        std::min(std::max(q.y, 0), height - 1)}];
+            } else {
+                values[i] = input[Point{(q.x + width) % width,
+                        (q.y + height) % height}];
+            }
+        }
+        result[p] = kernel(input[p], values);
+    }
+    return result;
+}
+
+template<typename Neighborhood, typename Kernel>
+void checkStencil(const Neighborhood& neighborhood, Kernel kernel) {
+    for (Point size : {Point{1, 1}, Point{2, 3}, Point{3, 3}, Point{7, 5},
+            Point{40, 6}}) {
+        Matrix<int> input = createMatrix(size.x, size.y);
+        for (BorderMode border : borderModes) {
+            BOOST_TEST_CONTEXT("size " << size << " border "
+                    << static_cast<int>(border)) {
+                auto expected = applyStencilNaively(input, neighborhood,
+                        kernel, border, 100);
+                decltype(expected) output{input.width(), input.height()};
+                applyStencil(input, output, neighborhood, kernel, border, 100);
+                BOOST_TEST(output == expected);
+            }
+        }
+    }
+}
+
+struct CountPositive {
+    template<std::size_t size>
+    int operator()(int center, const std::array<int, size>& neighbors) const {
+        return (center > 0 ? 1 : 0) + std::count_if(
+                neighbors.begin(), neighbors.end(),
+                [](int value) { return value > 0; });
+    }
+};
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(StencilTest)
+
+BOOST_AUTO_TEST_CASE(WeightedSumSquare) {
+    checkStencil(SquareNeighborhood{},
+            WeightedSum<int, 4>{-4, {{1, 2, 3, 4}}});
+}
+
+BOOST_AUTO_TEST_CASE(WeightedSumDiagonal) {
+    checkStencil(SquareDiagonalNeighborhood{},
+            uniformWeights(SquareDiagonalNeighborhood{}, 0.5, 0.0625));
+}
+
+BOOST_AUTO_TEST_CASE(WeightedSumHex) {
+    checkStencil(HexNeighborhood{},
+            WeightedSum<int, 6>{1, {{1, 2, 3, 4, 5, 6}}});
+}
+
+BOOST_AUTO_TEST_CASE(MinMax) {
+    checkStencil(SquareNeighborhood{}, MinKernel{});
+    checkStencil(SquareDiagonalNeighborhood{}, MaxKernel{});
+    checkStencil(HexNeighborhood{}, MinKernel{});
+    checkStencil(HexNeighborhood{}, MaxKernel{});
+}
+
+BOOST_AUTO_TEST_CASE(UserKernel) {
+    checkStencil(SquareDiagonalNeighborhood{}, CountPositive{});
+    checkStencil(HexNeighborhood{}, CountPositive{});
+}
+
+BOOST_AUTO_TEST_CASE(Diffusion) {
+    Matrix<float> input{5, 5, 0.0f};
+    input[Point{2, 2}] = 1.0f;
+    Matrix<float> output{5, 5};
+    applyStencil(input, output, SquareNeighborhood{},
+            uniformWeights(SquareNeighborhood{}, 0.5f, 0.125f),
+            BorderMode::constant);
+    BOOST_TEST((output[Point{2, 2}]) == 0.5f);
+    BOOST_TEST((output[Point{2, 1}]) == 0.125f);
+    BOOST_TEST((output[Point{3, 2}]) == 0.125f);
+    BOOST_TEST((output[Point{3, 3}]) == 0.0f);
+    BOOST_TEST(kernels::sum(output) == 1.0f);
+}
+
+BOOST_AUTO_TEST_CASE(AlignedMatrices) {
+    Matrix<int> input = createMatrix(13, 4);
+    AlignedMatrix<int> alignedInput{input};
+    AlignedMatrix<int> output{13, 4};
+    WeightedSum<int, 4> kernel{1, {{1, 1, 1, 1}}};
+    applyStencil(alignedInput, output, SquareNeighborhood{}, kernel,
+            BorderMode::wrap);
+    auto expected = applyStencilNaively(input, SquareNeighborhood{}, kernel,
+            BorderMode::wrap, 0);
+    for (Point p : matrixRange(input)) {
+        BOOST_TEST_REQUIRE(output[p] == expected[p]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+    Matrix<int> input = createMatrix(31, 57);
+    WeightedSum<int, 6> kernel{2, {{1, -1, 2, -2, 3, -3}}};
+    auto expected = applyStencilNaively(input, HexNeighborhood{}, kernel,
+            BorderMode::clamp, 0);
+
+    util::ThreadPool threadPool{4};
+    util::ThreadPoolRunner runner{threadPool};
+    for (std::size_t grain : {0, 1, 5, 100}) {
+        Matrix<int> output{31, 57};
+        applyStencil(threadPool, input, output, HexNeighborhood{}, kernel,
+                BorderMode::clamp, 0, grain);
+        BOOST_TEST(output == expected);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // StencilTest
@@ -0,0 +1,126 @@
+#include "matrix/SummedAreaTable.hpp"
+
+#include "TestMatrices.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+
+using namespace util;
+using namespace util::matrix;
+using namespace util::matrix::test;
+
+namespace {
+
+template<typename MatrixType>
+long naiveSum(const MatrixType& matrix, Point begin, Point end) {
+    long result = 0;
+    for (Point p : PointRange{begin, end}) {
+        if (isInsideMatrix(matrix, p)) {
+            result += matrix[p];
+        }
+    }
+    return result;
+}
+
+template<typename MatrixType, typename Table>
+void checkAllRanges(const MatrixType& matrix, const Table& table) {
+    BOOST_TEST_REQUIRE(table.width() == matrix.width());
+    BOOST_TEST_REQUIRE(table.height() == matrix.height());
+    int width = matrix.width();
+    int height = matrix.height();
+    for (Point begin : PointRange{Point{0, 0}, Point{width, height}}) {
+        for (Point end : PointRange{begin, Point{width + 1, height + 1}}) {
+            BOOST_TEST_REQUIRE(table.sum(PointRange{begin, end}) ==
+                    naiveSum(matrix, begin, end));
+        }
+    }
+}
+
+} // unnamed namespace
+
+BOOST_AUTO_TEST_SUITE(SummedAreaTableTest)
+
+BOOST_AUTO_TEST_CASE(Sums) {
+    Matrix<int> matrix = createMatrix(7, 5);
+    SummedAreaTable<int> table{matrix};
+    checkAllRanges(matrix, table);
+    BOOST_TEST(table.total() == naiveSum(matrix, p00, Point{7, 5}));
+}
+
+BOOST_AUTO_TEST_CASE(ClippedRanges) {
+    Matrix<int> matrix{4, 3, 2};
+    SummedAreaTable<int> table{matrix};
+    PointRange range{Point{-2, -1}, Point{2, 10}};
+    BOOST_TEST(table.sum(range) == 12);
+    BOOST_TEST(table.count(range) == 6u);
+    BOOST_TEST(table.mean(range) == 2.0);
+
+    PointRange outside{Point{5, 0}, Point{8, 3}};
+    BOOST_TEST(table.sum(outside) == 0);
+    BOOST_TEST(table.count(outside) == 0u);
+    BOOST_TEST(table.mean(outside) == 0.0);
+
+    PointRange inverted{Point{3, 2}, Point{1, 1}};
+    BOOST_TEST(table.sum(inverted) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(Mean) {
+    Matrix<float> matrix{2, 2, {1.0f, 2.0f, 3.0f, 4.5f}};
+    SummedAreaTable<float> table{matrix};
+    BOOST_TEST(table.mean(PointRange{p00, Point{2, 2}}) == 2.625);
+    BOOST_TEST(table.mean(PointRange{p01, Point{2, 2}}) == 3.75);
+}
+
+BOOST_AUTO_TEST_CASE(NoOverflow) {
+    Matrix<std::uint8_t> matrix{300, 300, 255};
+    SummedAreaTable<std::uint8_t> table{matrix};
+    BOOST_TEST(table.total() == 300u * 300u * 255u);
+}
+
+BOOST_AUTO_TEST_CASE(Empty) {
+    SummedAreaTable<int> table{Matrix<int>{}};
+    BOOST_TEST(table.width() == 0u);
+    BOOST_TEST(table.height() == 0u);
+    BOOST_TEST(table.total() == 0);
+    BOOST_TEST(table.sum(PointRange{p00, p11}) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(View) {
+    Matrix<int> matrix = createMatrix(9, 8);
+    auto view = matrixView(matrix, Point{2, 1}, 5, 6);
+    SummedAreaTable<int> table{view};
+    checkAllRanges(view, table);
+}
+
+BOOST_AUTO_TEST_CASE(Update) {
+    Matrix<int> matrix = createMatrix(8, 6);
+    SummedAreaTable<int> table{matrix};
+    for (Point p : PointRange{Point{3, 2}, Point{6, 4}}) {
+        matrix[p] += 100;
+    }
+    table.update(matrix, PointRange{Point{3, 2}, Point{6, 4}});
+    checkAllRanges(matrix, table);
+
+    matrix[Point{7, 5}] = 1000;
+    table.update(matrix, PointRange{Point{7, 5}, Point{20, 20}});
+    checkAllRanges(matrix, table);
+
+    matrix[p00] = -1000;
+    table.update(matrix, PointRange{Point{-1, -1}, p11});
+    checkAllRanges(matrix, table);
+}
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+    ThreadPool threadPool{4};
+    ThreadPoolRunner runner{threadPool};
+    Matrix<int> matrix = createMatrix(9, 23);
+    for (std::size_t grain : {0, 1, 4, 22, 23, 100}) {
+        BOOST_TEST_CONTEXT("grain " << grain) {
+            SummedAreaTable<int> table{threadPool, matrix, grain};
+            checkAllRanges(matrix, table);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END() // SummedAreaTableTest
@@ -0,0 +1,51 @@
+#ifndef UT_TESTMATRICES_HPP
+#define UT_TESTMATRICES_HPP
+
+#include "matrix/Matrix.hpp"
+
+// Matrices with reproducible contents for the tests.
+
+namespace util {
+namespace matrix {
+namespace test {
+
+// Small values of both signs, without an obvious pattern in either
+// direction.
+template<typename T = int>
+Matrix<T> createMatrix(std::size_t width, std::size_t height) {
+    Matrix<T> result{width, height};
+    for (Point p : matrixRange(result)) {
+        result[p] = static_cast<T>((p.x * 37 + p.y * 101) % 23 - 11);
+    }
+    return result;
+}
+
+// Fills the matrix from a linear congruential generator, so the same seed
+// gives the same matrix on every platform. The function gets the upper 16
+// bits of the state for each cell and returns its value.
+template<typename T, typename Function>
+Matrix<T> createRandomMatrix(std::size_t width, std::size_t height,
+        unsigned seed, Function function) {
+    Matrix<T> result{width, height};
+    unsigned state = seed;
+    for (Point p : matrixRange(result)) {
+        state = state * 1103515245u + 12345u;
+        result[p] = function(state >> 16);
+    }
+    return result;
+}
+
+// A passability map where about wallPercent percent of the cells are walls.
+inline Matrix<bool> createRandomMap(std::size_t width, std::size_t height,
+        unsigned seed, unsigned wallPercent) {
+    return createRandomMatrix<bool>(width, height, seed,
+            [wallPercent](unsigned value) {
+                return value % 100 >= wallPercent;
+            });
+}
+
+} // namespace test
+} // namespace matrix
+} // namespace util
+
+#endif // UT_TESTMATRICES_HPP
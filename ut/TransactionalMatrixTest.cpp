@@ -0,0 +1,87 @@
+#include "matrix/MatrixIO.hpp"
+#include "matrix/TransactionalMatrix.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <functional>
+
+using namespace util::matrix;
+
+BOOST_AUTO_TEST_SUITE(TransactionalMatrixTest)
+
+BOOST_AUTO_TEST_CASE(ReadAndWrite) {
+    TransactionalMatrix<int> matrix{3, 2, 1};
+    matrix[Point{1, 1}] = 5;
+    matrix.set(Point{2, 0}, 7);
+    BOOST_TEST((matrix[Point{1, 1}]) == 5);
+    BOOST_TEST((matrix[Point{2, 0}]) == 7);
+    BOOST_TEST(matrix.journalSize() == 2);
+    BOOST_CHECK_EQUAL(matrix.matrix(), (Matrix<int>{3, 2, {1, 1, 7, 1, 5, 1}}));
+}
+
+BOOST_AUTO_TEST_CASE(Rollback) {
+    Matrix<int> original{3, 3, {1, 2, 3, 4, 5, 6, 7, 8, 9}};
+    TransactionalMatrix<int> matrix{original};
+    matrix[Point{0, 0}] = 10;
+    auto checkpoint = matrix.checkpoint();
+    matrix[Point{1, 1}] = 20;
+    matrix[Point{1, 1}] = 30;
+    matrix[Point{2, 2}] = 40;
+
+    matrix.rollback(checkpoint);
+    BOOST_TEST(matrix.journalSize() == 1);
+    BOOST_TEST((matrix[Point{0, 0}]) == 10);
+    BOOST_TEST((matrix[Point{1, 1}]) == 5);
+    BOOST_TEST((matrix[Point{2, 2}]) == 9);
+
+    matrix.rollback();
+    BOOST_CHECK_EQUAL(matrix.matrix(), original);
+    BOOST_TEST(matrix.journalSize() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(Commit) {
+    TransactionalMatrix<int> matrix{2, 2, 0};
+    matrix.reserveJournal(16);
+    matrix[Point{1, 0}] = 3;
+    matrix.commit();
+    BOOST_TEST(matrix.journalSize() == 0);
+    matrix[Point{0, 1}] = 4;
+    matrix.rollback();
+    BOOST_CHECK_EQUAL(matrix.matrix(), (Matrix<int>{2, 2, {0, 3, 0, 0}}));
+}
+
+// Depth-first enumeration of every 0/1 assignment of a 2x3 matrix, undoing
+// each level instead of copying.
+BOOST_AUTO_TEST_CASE(Backtracking) {
+    TransactionalMatrix<int> matrix{3, 2, -1};
+    int leaves = 0;
+    std::function<void(std::size_t)> search = [&](std::size_t index) {
+        if (index == matrix.size()) {
+            ++leaves;
+            return;
+        }
+        Point p(index % 3, index / 3);
+        for (int value : {0, 1}) {
+            auto checkpoint = matrix.checkpoint();
+            matrix[p] = value;
+            search(index + 1);
+            matrix.rollback(checkpoint);
+            BOOST_TEST_REQUIRE(matrix[p] == -1);
+        }
+    };
+    search(0);
+    BOOST_TEST(leaves == 64);
+    BOOST_CHECK_EQUAL(matrix.matrix(), (Matrix<int>{3, 2, -1}));
+    BOOST_TEST(matrix.journalSize() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(BulkOperationsCommit) {
+    TransactionalMatrix<int> matrix{2, 2, 0};
+    matrix[Point{1, 1}] = 1;
+    matrix.fill(5);
+    BOOST_TEST(matrix.journalSize() == 0);
+    matrix.rollback();
+    BOOST_CHECK(matrix == (TransactionalMatrix<int>{2, 2, 5}));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TransactionalMatrixTest